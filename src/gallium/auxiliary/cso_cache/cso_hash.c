@@ -85,6 +85,7 @@ struct cso_hash_data {
    short userNumBits;
    short numBits;
    int numBuckets;
+   struct cso_node *freeNodes;  /**< nodes freed for reuse */
 };
 
 struct cso_hash {
@@ -94,14 +95,26 @@ struct cso_hash {
    } data;
 };
 
+/**
+ * Allocate a node, reusing a previously freed one when possible so that
+ * caches which keep adding and evicting entries don't hit malloc for
+ * every insertion.
+ */
 static void *cso_data_allocate_node(struct cso_hash_data *hash)
 {
+   struct cso_node *node = hash->freeNodes;
+
+   if (node) {
+      hash->freeNodes = node->next;
+      return node;
+   }
    return MALLOC(hash->nodeSize);
 }
 
-static void cso_free_node(struct cso_node *node)
+static void cso_free_node(struct cso_hash_data *hash, struct cso_node *node)
 {
-   FREE(node);
+   node->next = hash->freeNodes;
+   hash->freeNodes = node;
 }
 
 static struct cso_node *
@@ -254,6 +267,7 @@ struct cso_hash * cso_hash_create(void)
    hash->data.d->userNumBits = (short)MinNumBits;
    hash->data.d->numBits = 0;
    hash->data.d->numBuckets = 0;
+   hash->data.d->freeNodes = NULL;
 
    return hash;
 }
@@ -262,15 +276,22 @@ void cso_hash_delete(struct cso_hash *hash)
 {
    struct cso_node *e_for_x = (struct cso_node *)(hash->data.d);
    struct cso_node **bucket = (struct cso_node **)(hash->data.d->buckets);
+   struct cso_node *cur;
    int n = hash->data.d->numBuckets;
    while (n--) {
-      struct cso_node *cur = *bucket++;
+      cur = *bucket++;
       while (cur != e_for_x) {
          struct cso_node *next = cur->next;
-         cso_free_node(cur);
+         FREE(cur);
          cur = next;
       }
    }
+   cur = hash->data.d->freeNodes;
+   while (cur) {
+      struct cso_node *next = cur->next;
+      FREE(cur);
+      cur = next;
+   }
    FREE(hash->data.d->buckets);
    FREE(hash->data.d);
    FREE(hash);
@@ -386,7 +407,7 @@ void * cso_hash_take(struct cso_hash *hash,
    if (*node != hash->data.e) {
       void *t = (*node)->value;
       struct cso_node *next = (*node)->next;
-      cso_free_node(*node);
+      cso_free_node(hash->data.d, *node);
       *node = next;
       --hash->data.d->size;
       cso_data_has_shrunk(hash->data.d);
@@ -427,7 +448,7 @@ struct cso_hash_iter cso_hash_erase(struct cso_hash *hash, struct cso_hash_iter
    while (*node_ptr != node)
       node_ptr = &(*node_ptr)->next;
    *node_ptr = node->next;
-   cso_free_node(node);
+   cso_free_node(hash->data.d, node);
    --hash->data.d->size;
    return ret;
 }
@@ -1135,6 +1135,83 @@ fetch_src_file_channel(const struct tgsi_exec_machine *mach,
    }
 }
 
+/**
+ * Fetch a directly addressed source register (no indirection, no second
+ * dimension).  This is by far the most common kind of operand, and since
+ * the register index is the same for all four channels we can read the
+ * register once instead of building per-channel index vectors.
+ * Returns FALSE if the register file isn't handled here.
+ */
+static INLINE boolean
+fetch_direct_src_file_channel(const struct tgsi_exec_machine *mach,
+                              const uint file,
+                              const int index,
+                              const uint swizzle,
+                              union tgsi_exec_channel *chan)
+{
+   switch (file) {
+   case TGSI_FILE_TEMPORARY:
+      assert(index < TGSI_EXEC_NUM_TEMPS);
+      *chan = mach->Temps[index].xyzw[swizzle];
+      return TRUE;
+
+   case TGSI_FILE_INPUT:
+      assert(index < TGSI_MAX_PRIM_VERTICES * PIPE_MAX_ATTRIBS);
+      *chan = mach->Inputs[index].xyzw[swizzle];
+      return TRUE;
+
+   case TGSI_FILE_IMMEDIATE:
+      assert(index < (int)mach->ImmLimit);
+      chan->f[0] =
+      chan->f[1] =
+      chan->f[2] =
+      chan->f[3] = mach->Imms[index][swizzle];
+      return TRUE;
+
+   case TGSI_FILE_CONSTANT:
+      {
+         const uint *buf = (const uint *)mach->Consts[0];
+         const int pos = index * 4 + swizzle;
+         uint value = 0;
+
+         assert(buf);
+         /* const buffer bounds check */
+         if (pos >= 0 && pos < (int) mach->ConstsSize[0])
+            value = buf[pos];
+         chan->u[0] =
+         chan->u[1] =
+         chan->u[2] =
+         chan->u[3] = value;
+      }
+      return TRUE;
+
+   default:
+      return FALSE;
+   }
+}
+
+static INLINE void
+apply_src_modifiers(union tgsi_exec_channel *chan,
+                    const struct tgsi_full_src_register *reg,
+                    enum tgsi_exec_datatype src_datatype)
+{
+   if (reg->Register.Absolute) {
+      if (src_datatype == TGSI_EXEC_DATA_FLOAT) {
+         micro_abs(chan, chan);
+      } else {
+         micro_iabs(chan, chan);
+      }
+   }
+
+   if (reg->Register.Negate) {
+      if (src_datatype == TGSI_EXEC_DATA_FLOAT) {
+         micro_neg(chan, chan);
+      } else {
+         micro_ineg(chan, chan);
+      }
+   }
+}
+
 static void
 fetch_source(const struct tgsi_exec_machine *mach,
              union tgsi_exec_channel *chan,
@@ -1146,6 +1223,18 @@ fetch_source(const struct tgsi_exec_machine *mach,
    union tgsi_exec_channel index2D;
    uint swizzle;
 
+   if (!reg->Register.Indirect && !reg->Register.Dimension) {
+      swizzle = tgsi_util_get_full_src_register_swizzle( reg, chan_index );
+      if (fetch_direct_src_file_channel(mach,
+                                        reg->Register.File,
+                                        reg->Register.Index,
+                                        swizzle,
+                                        chan)) {
+         apply_src_modifiers(chan, reg, src_datatype);
+         return;
+      }
+   }
+
    /* We start with a direct index into a register file.
     *
     *    file[1],
@@ -1284,21 +1373,7 @@ fetch_source(const struct tgsi_exec_machine *mach,
                           &index2D,
                           chan);
 
-   if (reg->Register.Absolute) {
-      if (src_datatype == TGSI_EXEC_DATA_FLOAT) {
-         micro_abs(chan, chan);
-      } else {
-         micro_iabs(chan, chan);
-      }
-   }
-
-   if (reg->Register.Negate) {
-      if (src_datatype == TGSI_EXEC_DATA_FLOAT) {
-         micro_neg(chan, chan);
-      } else {
-         micro_ineg(chan, chan);
-      }
-   }
+   apply_src_modifiers(chan, reg, src_datatype);
 }
 
 static void
@@ -584,6 +584,36 @@ def generate_pack_kernel(format, src_channel, src_native_type):
         print_channels(format, pack_into_union)
 
 
+def is_format_native_type(format, channel):
+    '''Whether the pixels of the format are laid out in memory exactly as
+    an array of four channels of the given type, in RGBA order.'''
+
+    if format.layout != PLAIN or format.colorspace != RGB:
+        return False
+    if format.block_width != 1 or format.block_height != 1:
+        return False
+    if format.nr_channels() != 4:
+        return False
+    for i in range(4):
+        if not format.le_channels[i] == channel:
+            return False
+        if format.le_swizzles[i] != i:
+            return False
+    return True
+
+
+def generate_copy_rows(bytes_per_row):
+    '''Generate the body of an unpack/pack function which is a plain copy
+    of each row.'''
+
+    print '   unsigned y;'
+    print '   for(y = 0; y < height; y += 1) {'
+    print '      memcpy(dst_row, src_row, %s);' % bytes_per_row
+    print '      dst_row += dst_stride/sizeof(*dst_row);'
+    print '      src_row += src_stride/sizeof(*src_row);'
+    print '   }'
+
+
 def generate_format_unpack(format, dst_channel, dst_native_type, dst_suffix):
     '''Generate the function to unpack pixels from a particular format'''
 
@@ -593,7 +623,9 @@ def generate_format_unpack(format, dst_channel, dst_native_type, dst_suffix):
     print 'util_format_%s_unpack_%s(%s *dst_row, unsigned dst_stride, const uint8_t *src_row, unsigned src_stride, unsigned width, unsigned height)' % (name, dst_suffix, dst_native_type)
     print '{'
 
-    if is_format_supported(format):
+    if is_format_native_type(format, dst_channel):
+        generate_copy_rows('width * 4 * sizeof(*dst_row)')
+    elif is_format_supported(format):
         print '   unsigned x, y;'
         print '   for(y = 0; y < height; y += %u) {' % (format.block_height,)
         print '      %s *dst = dst_row;' % (dst_native_type)
@@ -622,7 +654,9 @@ def generate_format_pack(format, src_channel, src_native_type, src_suffix):
     print 'util_format_%s_pack_%s(uint8_t *dst_row, unsigned dst_stride, const %s *src_row, unsigned src_stride, unsigned width, unsigned height)' % (name, src_suffix, src_native_type)
     print '{'
     
-    if is_format_supported(format):
+    if is_format_native_type(format, src_channel):
+        generate_copy_rows('width * 4 * sizeof(*src_row)')
+    elif is_format_supported(format):
         print '   unsigned x, y;'
         print '   for(y = 0; y < height; y += %u) {' % (format.block_height,)
         print '      const %s *src = src_row;' % (src_native_type)
@@ -37,6 +37,7 @@
 #include "sp_quad_pipe.h"
 #include "sp_setup.h"
 #include "sp_state.h"
+#include "sp_tile_cache.h"
 #include "draw/draw_context.h"
 #include "draw/draw_vertex.h"
 #include "pipe/p_shader_tokens.h"
@@ -188,7 +189,26 @@ block(int x)
 static INLINE int
 block_x(int x)
 {
-   return x & ~(16-1);
+   return x & ~(2 * MAX_QUADS - 1);
+}
+
+
+/**
+ * Return the pixel coverage mask of one row of a span chunk, with
+ * 'skip_left' pixels cleared on the left and 'skip_right' pixels
+ * cleared on the right.  Bit n corresponds to pixel n of the chunk.
+ */
+static INLINE unsigned
+span_row_mask(unsigned skip_left, unsigned skip_right)
+{
+   unsigned mask = ~0U;
+
+   if (skip_left)
+      mask &= skip_left < 32 ? ~0U << skip_left : 0U;
+   if (skip_right)
+      mask &= skip_right < 32 ? ~0U >> skip_right : 0U;
+
+   return mask;
 }
 
 
@@ -198,7 +218,8 @@ block_x(int x)
 static void
 flush_spans(struct setup_context *setup)
 {
-   const int step = MAX_QUADS;
+   /* one bit per pixel, so a chunk is MAX_QUADS quads wide */
+   const int step = 2 * MAX_QUADS;
    const int xleft0 = setup->span.left[0];
    const int xleft1 = setup->span.left[1];
    const int xright0 = setup->span.right[0];
@@ -209,7 +230,13 @@ flush_spans(struct setup_context *setup)
    const int maxright = MAX2(xright0, xright1);
    int x;
 
-   /* process quads in horizontal chunks of 16 */
+   /* Process quads in horizontal chunks of 32 pixels.  The chunks are
+    * aligned so that they never straddle a TILE_SIZE boundary, which the
+    * quad stages rely on.
+    */
+   STATIC_ASSERT(2 * MAX_QUADS == 32);
+   STATIC_ASSERT(TILE_SIZE % (2 * MAX_QUADS) == 0);
+
    for (x = minleft; x < maxright; x += step) {
       unsigned skip_left0 = CLAMP(xleft0 - x, 0, step);
       unsigned skip_left1 = CLAMP(xleft1 - x, 0, step);
@@ -218,16 +245,8 @@ flush_spans(struct setup_context *setup)
       unsigned lx = x;
       unsigned q = 0;
 
-      unsigned skipmask_left0 = (1U << skip_left0) - 1U;
-      unsigned skipmask_left1 = (1U << skip_left1) - 1U;
-
-      /* These calculations fail when step == 32 and skip_right == 0.
-       */
-      unsigned skipmask_right0 = ~0U << (unsigned)(step - skip_right0);
-      unsigned skipmask_right1 = ~0U << (unsigned)(step - skip_right1);
-
-      unsigned mask0 = ~skipmask_left0 & ~skipmask_right0;
-      unsigned mask1 = ~skipmask_left1 & ~skipmask_right1;
+      unsigned mask0 = span_row_mask(skip_left0, skip_right0);
+      unsigned mask1 = span_row_mask(skip_left1, skip_right1);
 
       if (mask0 | mask1) {
          do {
@@ -102,6 +102,23 @@ sp_tex_tile_cache_validate_texture(struct softpipe_tex_tile_cache *tc)
    }
 }
 
+/**
+ * Can tiles of the given format be converted straight out of the mapped
+ * texture?  This is true for uncompressed color formats with one texel
+ * per block; everything else goes through the u_tile helpers.
+ */
+static INLINE boolean
+tex_tile_direct_read(enum pipe_format format)
+{
+   const struct util_format_description *desc = util_format_description(format);
+
+   return desc->layout == UTIL_FORMAT_LAYOUT_PLAIN &&
+          desc->colorspace != UTIL_FORMAT_COLORSPACE_ZS &&
+          desc->block.width == 1 &&
+          desc->block.height == 1;
+}
+
+
 static boolean
 sp_tex_tile_is_compat_view(struct softpipe_tex_tile_cache *tc,
                            struct pipe_sampler_view *view)
@@ -143,6 +160,7 @@ sp_tex_tile_cache_set_sampler_view(struct softpipe_tex_tile_cache *tc,
          tc->swizzle_b = view->swizzle_b;
          tc->swizzle_a = view->swizzle_a;
          tc->format = view->format;
+         tc->direct_read = tex_tile_direct_read(view->format);
       }
 
       /* mark as entries as invalid/empty */
@@ -197,6 +215,46 @@ tex_cache_pos( union tex_tile_address addr )
    return entry % NUM_TEX_TILE_ENTRIES;
 }
 
+/**
+ * Convert the texels of a tile directly from the texture mapping into the
+ * tile.  Unlike pipe_get_tile_rgba_format() and friends this doesn't
+ * allocate and fill a temporary packed copy of the tile on every miss.
+ */
+static void
+tex_tile_read(const struct softpipe_tex_tile_cache *tc,
+              struct softpipe_tex_cached_tile *tile,
+              union tex_tile_address addr)
+{
+   const unsigned x = addr.bits.x * TEX_TILE_SIZE;
+   const unsigned y = addr.bits.y * TEX_TILE_SIZE;
+   const unsigned src_stride = tc->tex_trans->stride;
+   unsigned w = TEX_TILE_SIZE, h = TEX_TILE_SIZE;
+
+   if (u_clip_tile(x, y, &w, &h, &tc->tex_trans->box))
+      return;
+
+   if (util_format_is_pure_uint(tc->format)) {
+      util_format_read_4ui(tc->format,
+                           tile->data.colorui[0][0],
+                           sizeof(tile->data.colorui[0]),
+                           tc->tex_trans_map, src_stride,
+                           x, y, w, h);
+   } else if (util_format_is_pure_sint(tc->format)) {
+      util_format_read_4i(tc->format,
+                          tile->data.colori[0][0],
+                          sizeof(tile->data.colori[0]),
+                          tc->tex_trans_map, src_stride,
+                          x, y, w, h);
+   } else {
+      util_format_read_4f(tc->format,
+                          tile->data.color[0][0],
+                          sizeof(tile->data.color[0]),
+                          tc->tex_trans_map, src_stride,
+                          x, y, w, h);
+   }
+}
+
+
 /**
  * Similar to sp_get_cached_tile() but for textures.
  * Tiles are read-only and indexed with more params.
@@ -263,7 +321,9 @@ sp_find_cached_tile_tex(struct softpipe_tex_tile_cache *tc,
       /* Get tile from the transfer (view into texture), explicitly passing
        * the image format.
        */
-      if (!zs && util_format_is_pure_uint(tc->format)) {
+      if (tc->direct_read) {
+         tex_tile_read(tc, tile, addr);
+      } else if (!zs && util_format_is_pure_uint(tc->format)) {
          pipe_get_tile_ui_format(tc->tex_trans, tc->tex_trans_map,
                                  addr.bits.x * TEX_TILE_SIZE,
                                  addr.bits.y * TEX_TILE_SIZE,
@@ -101,6 +101,7 @@ struct softpipe_tex_tile_cache
    unsigned swizzle_b;
    unsigned swizzle_a;
    enum pipe_format format;
+   boolean direct_read;   /**< convert tiles straight from the mapping? */
 
    struct softpipe_tex_cached_tile *last_tile;  /**< most recently retrieved tile */
 };
@@ -42,14 +42,14 @@ static struct softpipe_cached_tile *
 sp_alloc_tile(struct softpipe_tile_cache *tc);
 
 
+#define NUM_SETS (NUM_ENTRIES / CACHE_WAYS)
+
 /**
- * Return the position in the cache for the tile that contains win pos (x,y).
- * We currently use a direct mapped cache so this is like a hack key.
- * At some point we should investige something more sophisticated, like
- * a LRU replacement policy.
+ * Return the first cache position of the set holding the tile that
+ * contains win pos (x,y).
  */
-#define CACHE_POS(x, y, l)                        \
-   (((x) + (y) * 5 + (l) * 10) % NUM_ENTRIES)
+#define CACHE_SET_POS(x, y, l)                                  \
+   ((((x) + (y) * 5 + (l) * 10) % NUM_SETS) * CACHE_WAYS)
 
 
 static INLINE int addr_to_clear_pos(union tile_address addr)
@@ -508,6 +508,35 @@ sp_alloc_tile(struct softpipe_tile_cache *tc)
    return tile;
 }
 
+/**
+ * Find the cache position to use for a tile at 'addr'.  This is either
+ * the position already holding the tile, an empty position of the set
+ * or the least recently used position of the set.
+ */
+static INLINE int
+sp_find_tile_pos(const struct softpipe_tile_cache *tc,
+                 union tile_address addr)
+{
+   const int first = CACHE_SET_POS(addr.bits.x,
+                                   addr.bits.y, addr.bits.layer);
+   int pos, victim = first;
+
+   for (pos = first; pos < first + CACHE_WAYS; pos++) {
+      if (tc->tile_addrs[pos].value == addr.value)
+         return pos;
+   }
+
+   for (pos = first; pos < first + CACHE_WAYS; pos++) {
+      if (tc->tile_addrs[pos].bits.invalid)
+         return pos;
+      if (tc->use_count - tc->last_used[pos] >
+          tc->use_count - tc->last_used[victim])
+         victim = pos;
+   }
+
+   return victim;
+}
+
 /**
  * Get a tile from the cache.
  * \param x, y  position of tile, in pixels
@@ -518,8 +547,7 @@ sp_find_cached_tile(struct softpipe_tile_cache *tc,
 {
    struct pipe_transfer *pt;
    /* cache pos/entry: */
-   const int pos = CACHE_POS(addr.bits.x,
-                             addr.bits.y, addr.bits.layer);
+   const int pos = sp_find_tile_pos(tc, addr);
    struct softpipe_cached_tile *tile = tc->entries[pos];
    int layer;
    if (!tile) {
@@ -529,41 +557,8 @@ sp_find_cached_tile(struct softpipe_tile_cache *tc,
 
    if (addr.value != tc->tile_addrs[pos].value) {
 
-      layer = tc->tile_addrs[pos].bits.layer;
-      if (tc->tile_addrs[pos].bits.invalid == 0) {
-         /* put dirty tile back in framebuffer */
-         if (tc->depth_stencil) {
-            pipe_put_tile_raw(tc->transfer[layer], tc->transfer_map[layer],
-                              tc->tile_addrs[pos].bits.x * TILE_SIZE,
-                              tc->tile_addrs[pos].bits.y * TILE_SIZE,
-                              TILE_SIZE, TILE_SIZE,
-                              tile->data.depth32, 0/*STRIDE*/);
-         }
-         else {
-            if (util_format_is_pure_uint(tc->surface->format)) {
-               pipe_put_tile_ui_format(tc->transfer[layer], tc->transfer_map[layer],
-                                      tc->tile_addrs[pos].bits.x * TILE_SIZE,
-                                      tc->tile_addrs[pos].bits.y * TILE_SIZE,
-                                      TILE_SIZE, TILE_SIZE,
-                                      tc->surface->format,
-                                      (unsigned *) tile->data.colorui128);
-            } else if (util_format_is_pure_sint(tc->surface->format)) {
-               pipe_put_tile_i_format(tc->transfer[layer], tc->transfer_map[layer],
-                                      tc->tile_addrs[pos].bits.x * TILE_SIZE,
-                                      tc->tile_addrs[pos].bits.y * TILE_SIZE,
-                                      TILE_SIZE, TILE_SIZE,
-                                      tc->surface->format,
-                                      (int *) tile->data.colori128);
-            } else {
-               pipe_put_tile_rgba_format(tc->transfer[layer], tc->transfer_map[layer],
-                                         tc->tile_addrs[pos].bits.x * TILE_SIZE,
-                                         tc->tile_addrs[pos].bits.y * TILE_SIZE,
-                                         TILE_SIZE, TILE_SIZE,
-                                         tc->surface->format,
-                                         (float *) tile->data.color);
-            }
-         }
-      }
+      /* put dirty tile back in framebuffer */
+      sp_flush_tile(tc, pos);
 
       tc->tile_addrs[pos] = addr;
 
@@ -617,6 +612,7 @@ sp_find_cached_tile(struct softpipe_tile_cache *tc,
       }
    }
 
+   tc->last_used[pos] = ++tc->use_count;
    tc->last_tile = tile;
    tc->last_tile_addr = addr;
    return tile;
@@ -76,7 +76,12 @@ struct softpipe_cached_tile
    } data;
 };
 
-#define NUM_ENTRIES 50
+/**
+ * The cache is set-associative: a tile maps to one set of CACHE_WAYS
+ * entries and the least recently used entry of the set is replaced.
+ */
+#define CACHE_WAYS 4
+#define NUM_ENTRIES 64
 
 
 struct softpipe_tile_cache
@@ -89,6 +94,8 @@ struct softpipe_tile_cache
 
    union tile_address tile_addrs[NUM_ENTRIES];
    struct softpipe_cached_tile *entries[NUM_ENTRIES];
+   uint last_used[NUM_ENTRIES];   /**< use_count at last lookup, for LRU */
+   uint use_count;
    uint *clear_flags;
    uint clear_flags_size;
    union pipe_color_union clear_color; /**< for color bufs */
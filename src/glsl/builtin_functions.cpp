@@ -60,6 +60,7 @@
 #include "ir_builder.h"
 #include "glsl_parser_extras.h"
 #include "program/prog_instruction.h"
+#include "util/hash_table.h"
 #include <limits>
 
 #define M_PIf   ((float) M_PI)
@@ -407,15 +408,32 @@ public:
    /**
     * A shader to hold all the built-in signatures; created by this module.
     *
-    * This includes signatures for every built-in, regardless of version or
-    * enabled extensions.  The availability predicate associated with each
-    * signature allows matching_signature() to filter out the irrelevant ones.
+    * This includes signatures for every built-in that has been looked up so
+    * far, regardless of version or enabled extensions.  The availability
+    * predicate associated with each signature allows matching_signature() to
+    * filter out the irrelevant ones.
+    *
+    * Built-in functions are generated lazily, one function name at a time,
+    * the first time find() is asked for them.  Functions are only ever added
+    * to the symbol table, never modified or removed.
     */
    gl_shader *shader;
 
 private:
    void *mem_ctx;
 
+   /**
+    * Set of function names create_builtins() has already been run for,
+    * including names that turned out not to be built-ins at all.
+    */
+   struct hash_table *generated_names;
+
+   /**
+    * Name of the built-in function currently being generated by
+    * create_builtins(), or NULL to generate every function.
+    */
+   const char *lazy_name;
+
    /** Global variables used by built-in functions. */
    ir_variable *gl_ModelViewProjectionMatrix;
    ir_variable *gl_Vertex;
@@ -424,6 +442,18 @@ private:
    void create_intrinsics();
    void create_builtins();
 
+   /** Generate the built-in function \p name if that hasn't happened yet. */
+   void generate_function(const char *name);
+
+   /**
+    * Whether the function \p name should be emitted by the current
+    * create_builtins() pass.
+    */
+   bool wants_function(const char *name) const
+   {
+      return lazy_name == NULL || strcmp(name, lazy_name) == 0;
+   }
+
    /**
     * IR builder helpers:
     *
@@ -692,6 +722,8 @@ private:
  */
 builtin_builder::builtin_builder()
    : shader(NULL),
+     generated_names(NULL),
+     lazy_name(NULL),
      gl_ModelViewProjectionMatrix(NULL),
      gl_Vertex(NULL)
 {
@@ -716,6 +748,8 @@ builtin_builder::find(_mesa_glsl_parse_state *state,
     */
    state->uses_builtin_functions = true;
 
+   generate_function(name);
+
    ir_function *f = shader->symbols->get_function(name);
    if (f == NULL)
       return NULL;
@@ -736,9 +770,34 @@ builtin_builder::initialize()
       return;
 
    mem_ctx = ralloc_context(NULL);
+   generated_names = _mesa_hash_table_create(mem_ctx, _mesa_key_string_equal);
    create_shader();
+
+   /* Intrinsics are few and are called from the bodies of other built-ins,
+    * so always create them up front.  Everything else is generated on first
+    * use by generate_function().
+    */
    create_intrinsics();
+}
+
+void
+builtin_builder::generate_function(const char *name)
+{
+   const uint32_t hash = _mesa_hash_string(name);
+
+   if (_mesa_hash_table_search(generated_names, hash, name) != NULL)
+      return;
+
+   /* Run through the list of every built-in, but only build the IR for the
+    * signatures of the requested function.  Names that aren't built-ins are
+    * remembered too, so that they aren't searched for again.
+    */
+   lazy_name = name;
    create_builtins();
+   lazy_name = NULL;
+
+   const char *key = ralloc_strdup(mem_ctx, name);
+   _mesa_hash_table_insert(generated_names, hash, key, (void *) key);
 }
 
 void
@@ -746,6 +805,7 @@ builtin_builder::release()
 {
    ralloc_free(mem_ctx);
    mem_ctx = NULL;
+   generated_names = NULL;
 
    ralloc_free(shader);
    shader = NULL;
@@ -801,11 +861,19 @@ builtin_builder::create_intrinsics()
 /**
  * Create ir_function and ir_function_signature objects for each built-in.
  *
- * Contains a list of every available built-in.
+ * Contains a list of every available built-in.  When lazy_name is set, only
+ * the function with that name is created; the signature generators of every
+ * other entry aren't even evaluated.
  */
 void
 builtin_builder::create_builtins()
 {
+#define add_function(NAME, ...)                                   \
+   do {                                                           \
+      if (wants_function(NAME))                                   \
+         builtin_builder::add_function(NAME, __VA_ARGS__);        \
+   } while (0)
+
 #define F(NAME)                                 \
    add_function(#NAME,                          \
                 _##NAME(glsl_type::float_type), \
@@ -2312,6 +2380,7 @@ builtin_builder::create_builtins()
 #undef FIU
 #undef FIUB
 #undef FIU2_MIXED
+#undef add_function
 }
 
 void
@@ -2381,6 +2450,10 @@ builtin_builder::add_image_function(const char *name,
       glsl_type::uimage2DMS_type,
       glsl_type::uimage2DMSArray_type
    };
+
+   if (!wants_function(name))
+      return;
+
    ir_function *f = new(mem_ctx) ir_function(name);
 
    for (unsigned i = 0; i < Elements(types); ++i) {
@@ -4571,10 +4644,27 @@ _mesa_glsl_find_builtin_function(_mesa_glsl_parse_state *state,
    return s;
 }
 
+/**
+ * The built-in shader keeps growing as built-ins are generated on first
+ * use, so its contents may only be looked at while holding the lock taken
+ * by _mesa_glsl_lock_builtin_functions().
+ */
 gl_shader *
 _mesa_glsl_get_builtin_function_shader()
 {
    return builtins.shader;
 }
 
+void
+_mesa_glsl_lock_builtin_functions()
+{
+   mtx_lock(&builtins_lock);
+}
+
+void
+_mesa_glsl_unlock_builtin_functions()
+{
+   mtx_unlock(&builtins_lock);
+}
+
 /** @} */
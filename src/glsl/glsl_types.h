@@ -614,6 +614,12 @@ private:
     */
    static void *mem_ctx;
 
+   /**
+    * Protects mem_ctx and the array, record and interface type tables, so
+    * that types can be created from several threads at once.
+    */
+   static mtx_t mutex;
+
    void init_ralloc_type_ctx(void);
 
    /** Constructor for vector and matrix types */
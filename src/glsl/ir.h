@@ -2327,6 +2327,12 @@ _mesa_glsl_find_builtin_function(_mesa_glsl_parse_state *state,
 extern gl_shader *
 _mesa_glsl_get_builtin_function_shader(void);
 
+extern void
+_mesa_glsl_lock_builtin_functions(void);
+
+extern void
+_mesa_glsl_unlock_builtin_functions(void);
+
 extern void
 _mesa_glsl_release_functions(void);
 
@@ -1707,9 +1707,13 @@ link_intrastage_shaders(void *mem_ctx,
       gl_shader **linking_shaders = (gl_shader **)
          calloc(num_shaders + 1, sizeof(gl_shader *));
       memcpy(linking_shaders, shader_list, num_shaders * sizeof(gl_shader *));
+
+      /* Other threads may be adding built-ins to the shader. */
+      _mesa_glsl_lock_builtin_functions();
       linking_shaders[num_shaders] = _mesa_glsl_get_builtin_function_shader();
 
       ok = link_function_calls(prog, linked, linking_shaders, num_shaders + 1);
+      _mesa_glsl_unlock_builtin_functions();
 
       free(linking_shaders);
    } else {
@@ -2450,6 +2454,80 @@ check_explicit_uniform_locations(struct gl_context *ctx,
    delete uniform_map;
 }
 
+namespace {
+
+/**
+ * Common optimization of one linked shader stage.
+ */
+struct stage_optimization {
+   struct gl_context *ctx;
+   struct gl_shader *shader;
+   unsigned stage;
+   thrd_t thread;
+   bool threaded;
+};
+
+} /* anonymous namespace */
+
+static int
+optimize_linked_stage(void *data)
+{
+   const stage_optimization *job = (const stage_optimization *) data;
+   struct gl_context *ctx = job->ctx;
+
+   while (do_common_optimization(job->shader->ir, true, false,
+                                 &ctx->Const.ShaderCompilerOptions[job->stage],
+                                 ctx->Const.NativeIntegers))
+      ;
+
+   return 0;
+}
+
+/**
+ * Run the common optimization loop on every linked stage.
+ *
+ * The stages' IR trees don't share anything but glsl_types, which are
+ * protected by their own lock, so with MESA_GLSL=parallel each stage after
+ * the first is optimized on a thread of its own.  Nothing in the
+ * optimization passes writes to the info log, so there's no ordering to
+ * preserve between stages.
+ */
+static void
+optimize_linked_stages(struct gl_context *ctx, struct gl_shader_program *prog)
+{
+   stage_optimization jobs[MESA_SHADER_STAGES];
+   unsigned num_jobs = 0;
+
+   for (unsigned i = 0; i < MESA_SHADER_STAGES; i++) {
+      if (prog->_LinkedShaders[i] == NULL)
+         continue;
+
+      jobs[num_jobs].ctx = ctx;
+      jobs[num_jobs].shader = prog->_LinkedShaders[i];
+      jobs[num_jobs].stage = i;
+      jobs[num_jobs].threaded = false;
+      num_jobs++;
+   }
+
+   if (ctx->Shader.Flags & GLSL_PARALLEL_LINK) {
+      for (unsigned i = 1; i < num_jobs; i++) {
+         jobs[i].threaded = thrd_create(&jobs[i].thread, optimize_linked_stage,
+                                        &jobs[i]) == thrd_success;
+      }
+   }
+
+   /* Stages that didn't get a thread run on this one. */
+   for (unsigned i = 0; i < num_jobs; i++) {
+      if (!jobs[i].threaded)
+         optimize_linked_stage(&jobs[i]);
+   }
+
+   for (unsigned i = 0; i < num_jobs; i++) {
+      if (jobs[i].threaded)
+         thrd_join(jobs[i].thread, NULL);
+   }
+}
+
 void
 link_shaders(struct gl_context *ctx, struct gl_shader_program *prog)
 {
@@ -2665,13 +2743,10 @@ link_shaders(struct gl_context *ctx, struct gl_shader_program *prog)
       if (ctx->Const.ShaderCompilerOptions[i].LowerClipDistance) {
          lower_clip_distance(prog->_LinkedShaders[i]);
       }
-
-      while (do_common_optimization(prog->_LinkedShaders[i]->ir, true, false,
-                                    &ctx->Const.ShaderCompilerOptions[i],
-                                    ctx->Const.NativeIntegers))
-	 ;
    }
 
+   optimize_linked_stages(ctx, prog);
+
    /* Check and validate stream emissions in geometry shaders */
    validate_geometry_shader_emissions(ctx, prog);
 
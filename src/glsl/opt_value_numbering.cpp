@@ -0,0 +1,610 @@
+/*
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * \file opt_value_numbering.cpp
+ *
+ * Dominator-based value numbering of single-assignment variables.
+ *
+ * Most temporaries created by the front-end, function inlining and
+ * expression flattening are written exactly once, by a single unconditional
+ * assignment of the whole variable.  Such a variable behaves like an SSA
+ * value: everywhere its assignment dominates, it holds the same value.
+ * Only variables local to a function are considered, since globals may be
+ * read by other functions before the assignment runs.
+ *
+ * With structured control flow, an instruction dominates the instructions
+ * following it in the same list and everything nested in those.  This pass
+ * walks the instruction tree in that order, keeping a scoped table of the
+ * values computed by the single-assignment variables defined so far.  An
+ * assignment whose right-hand side only reads constants, read-only
+ * variables (uniforms, shader inputs, system values) and single-assignment
+ * variables in scope is compared against the table:
+ *
+ * - If an equal value is already held by a dominating variable, the
+ *   right-hand side is replaced by a reference to that variable.  Values
+ *   are looked up by a hash of the expression tree.
+ *
+ * - Later reads of a variable that is just a copy of another value are
+ *   rewritten to read the original variable, so the copy becomes dead.
+ *
+ * Unlike do_cse(), which only looks at one basic block at a time, values
+ * are reused across if-statements and loops.  Dead copies are left to
+ * do_dead_code() and friends.
+ */
+
+#include "ir.h"
+#include "ir_visitor.h"
+#include "ir_rvalue_visitor.h"
+#include "ir_optimization.h"
+#include "glsl_types.h"
+#include "util/hash_table.h"
+
+static bool debug = false;
+
+namespace {
+
+/**
+ * A single-assignment variable whose definition is in scope.
+ */
+class vn_entry : public exec_node
+{
+public:
+   vn_entry(ir_variable *var, ir_rvalue *value, uint32_t hash,
+            ir_variable *leader, unsigned depth)
+      : var(var), value(value), hash(hash), leader(leader), depth(depth)
+   {
+   }
+
+   /** The variable holding the value. */
+   ir_variable *var;
+
+   /**
+    * The value computed by the variable's assignment, or NULL if it isn't
+    * something that can be numbered.
+    */
+   ir_rvalue *value;
+
+   /** Hash of \c value, see hash_value(). */
+   uint32_t hash;
+
+   /**
+    * Another variable holding the same value, whose definition dominates
+    * this one.  Reads of \c var are rewritten to read \c leader instead.
+    */
+   ir_variable *leader;
+
+   /** Nesting depth of the instruction list the assignment appears in. */
+   unsigned depth;
+};
+
+/**
+ * Counts the writes to every variable, including writes through out
+ * parameters and return values of calls.
+ */
+class write_count_visitor : public ir_hierarchical_visitor {
+public:
+   write_count_visitor()
+   {
+      this->ht = _mesa_hash_table_create(NULL, _mesa_key_pointer_equal);
+   }
+
+   ~write_count_visitor()
+   {
+      _mesa_hash_table_destroy(this->ht, NULL);
+   }
+
+   virtual ir_visitor_status visit_leave(ir_assignment *);
+   virtual ir_visitor_status visit_enter(ir_call *);
+
+   void add_write(ir_variable *var);
+   unsigned get_count(ir_variable *var);
+
+   struct hash_table *ht;
+};
+
+/**
+ * Replaces reads of copies with reads of the variable they copy.
+ */
+class leader_rewriter : public ir_rvalue_visitor {
+public:
+   leader_rewriter(struct hash_table *defs)
+      : defs(defs), progress(false)
+   {
+   }
+
+   virtual void handle_rvalue(ir_rvalue **rvalue);
+
+   struct hash_table *defs;
+   bool progress;
+};
+
+/**
+ * Checks whether an rvalue only reads values that can't change between
+ * its definition and any instruction it dominates.
+ */
+class invariant_visitor : public ir_hierarchical_visitor {
+public:
+   invariant_visitor(struct hash_table *defs)
+      : defs(defs), invariant(true)
+   {
+   }
+
+   virtual ir_visitor_status visit(ir_dereference_variable *);
+   virtual ir_visitor_status visit_enter(ir_call *);
+
+   struct hash_table *defs;
+   bool invariant;
+};
+
+class value_numbering {
+public:
+   value_numbering(write_count_visitor *writes)
+      : writes(writes), depth(0), in_function(false), progress(false)
+   {
+      this->defs = _mesa_hash_table_create(NULL, _mesa_key_pointer_equal);
+      this->value_table = _mesa_hash_table_create(NULL, values_equal);
+      this->locals = _mesa_hash_table_create(NULL, _mesa_key_pointer_equal);
+      this->mem_ctx = ralloc_context(NULL);
+   }
+
+   ~value_numbering()
+   {
+      _mesa_hash_table_destroy(this->defs, NULL);
+      _mesa_hash_table_destroy(this->value_table, NULL);
+      _mesa_hash_table_destroy(this->locals, NULL);
+      ralloc_free(this->mem_ctx);
+   }
+
+   static bool values_equal(const void *a, const void *b);
+
+   void process_list(exec_list *instructions);
+   void process_assignment(ir_assignment *ir);
+   void rewrite(ir_instruction *ir);
+   void rewrite(ir_rvalue **rvalue);
+
+   bool is_candidate(ir_assignment *ir);
+   bool can_number(ir_rvalue *rvalue);
+   void add_entry(ir_variable *var, ir_rvalue *value, uint32_t hash,
+                  ir_variable *leader);
+   void remove_entry(vn_entry *entry);
+
+   write_count_visitor *writes;
+
+   /** Single-assignment variables in scope, innermost first. */
+   exec_list values;
+
+   /** Maps each variable in \c values to its vn_entry. */
+   struct hash_table *defs;
+
+   /** Maps the values held by the entries in \c values to the entry. */
+   struct hash_table *value_table;
+
+   /** Set of the variables declared inside a function body. */
+   struct hash_table *locals;
+
+   unsigned depth;
+   bool in_function;
+   bool progress;
+   void *mem_ctx;
+};
+
+} /* unnamed namespace */
+
+static vn_entry *
+find_def(struct hash_table *defs, ir_variable *var)
+{
+   struct hash_entry *e =
+      _mesa_hash_table_search(defs, _mesa_hash_pointer(var), var);
+
+   return e ? (vn_entry *) e->data : NULL;
+}
+
+/**
+ * Hashes an rvalue such that values which are equal according to
+ * ir_rvalue::equals() get the same hash.
+ */
+static uint32_t
+hash_value(ir_rvalue *rvalue)
+{
+   uint32_t hash = rvalue->ir_type * 31 + _mesa_hash_pointer(rvalue->type);
+
+   switch (rvalue->ir_type) {
+   case ir_type_expression: {
+      ir_expression *expr = (ir_expression *) rvalue;
+
+      hash = hash * 31 + expr->operation;
+      for (unsigned i = 0; i < expr->get_num_operands(); i++)
+         hash = hash * 31 + hash_value(expr->operands[i]);
+      break;
+   }
+
+   case ir_type_swizzle: {
+      ir_swizzle *swiz = (ir_swizzle *) rvalue;
+
+      hash = hash * 31 + (swiz->mask.x | swiz->mask.y << 2 |
+                          swiz->mask.z << 4 | swiz->mask.w << 6);
+      hash = hash * 31 + hash_value(swiz->val);
+      break;
+   }
+
+   case ir_type_texture: {
+      ir_texture *tex = (ir_texture *) rvalue;
+
+      hash = hash * 31 + tex->op;
+      hash = hash * 31 + hash_value(tex->sampler);
+      if (tex->coordinate)
+         hash = hash * 31 + hash_value(tex->coordinate);
+      break;
+   }
+
+   case ir_type_dereference_array: {
+      ir_dereference_array *deref = (ir_dereference_array *) rvalue;
+
+      hash = hash * 31 + hash_value(deref->array);
+      hash = hash * 31 + hash_value(deref->array_index);
+      break;
+   }
+
+   case ir_type_dereference_variable:
+      hash = hash * 31 +
+         _mesa_hash_pointer(((ir_dereference_variable *) rvalue)->var);
+      break;
+
+   case ir_type_constant:
+      hash = hash * 31 +
+         _mesa_hash_data(((ir_constant *) rvalue)->value.u,
+                         rvalue->type->components() * sizeof(unsigned));
+      break;
+
+   default:
+      break;
+   }
+
+   return hash;
+}
+
+static bool
+is_read_only(const ir_variable *var)
+{
+   switch (var->data.mode) {
+   case ir_var_uniform:
+   case ir_var_shader_in:
+   case ir_var_system_value:
+   case ir_var_const_in:
+      return true;
+   default:
+      return false;
+   }
+}
+
+void
+write_count_visitor::add_write(ir_variable *var)
+{
+   const uint32_t hash = _mesa_hash_pointer(var);
+   struct hash_entry *e = _mesa_hash_table_search(this->ht, hash, var);
+
+   if (e)
+      e->data = (void *) ((intptr_t) e->data + 1);
+   else
+      _mesa_hash_table_insert(this->ht, hash, var, (void *) (intptr_t) 1);
+}
+
+unsigned
+write_count_visitor::get_count(ir_variable *var)
+{
+   struct hash_entry *e =
+      _mesa_hash_table_search(this->ht, _mesa_hash_pointer(var), var);
+
+   return e ? (unsigned) (intptr_t) e->data : 0;
+}
+
+ir_visitor_status
+write_count_visitor::visit_leave(ir_assignment *ir)
+{
+   add_write(ir->lhs->variable_referenced());
+   return visit_continue;
+}
+
+ir_visitor_status
+write_count_visitor::visit_enter(ir_call *ir)
+{
+   foreach_two_lists(formal_node, &ir->callee->parameters,
+                     actual_node, &ir->actual_parameters) {
+      ir_rvalue *param_rval = (ir_rvalue *) actual_node;
+      ir_variable *param = (ir_variable *) formal_node;
+
+      if (param->data.mode == ir_var_function_out ||
+          param->data.mode == ir_var_function_inout)
+         add_write(param_rval->variable_referenced());
+   }
+
+   if (ir->return_deref != NULL)
+      add_write(ir->return_deref->variable_referenced());
+
+   return visit_continue;
+}
+
+void
+leader_rewriter::handle_rvalue(ir_rvalue **rvalue)
+{
+   if (*rvalue == NULL || this->in_assignee)
+      return;
+
+   ir_dereference_variable *deref = (*rvalue)->as_dereference_variable();
+   if (deref == NULL)
+      return;
+
+   vn_entry *entry = find_def(this->defs, deref->var);
+   if (entry == NULL || entry->leader == NULL)
+      return;
+
+   if (debug) {
+      printf("value numbering: replacing read of %s with %s\n",
+             deref->var->name, entry->leader->name);
+   }
+
+   void *mem_ctx = ralloc_parent(deref);
+   *rvalue = new(mem_ctx) ir_dereference_variable(entry->leader);
+   this->progress = true;
+}
+
+ir_visitor_status
+invariant_visitor::visit(ir_dereference_variable *ir)
+{
+   if (is_read_only(ir->var) || find_def(this->defs, ir->var) != NULL)
+      return visit_continue;
+
+   this->invariant = false;
+   return visit_stop;
+}
+
+ir_visitor_status
+invariant_visitor::visit_enter(ir_call *)
+{
+   this->invariant = false;
+   return visit_stop;
+}
+
+/**
+ * Is \p ir the only write of a variable this pass can treat as a value?
+ */
+bool
+value_numbering::is_candidate(ir_assignment *ir)
+{
+   if (ir->condition)
+      return false;
+
+   ir_variable *var = ir->whole_variable_written();
+   if (var == NULL)
+      return false;
+
+   if (var->data.mode != ir_var_auto && var->data.mode != ir_var_temporary)
+      return false;
+
+   if (!_mesa_hash_table_search(this->locals, _mesa_hash_pointer(var), var))
+      return false;
+
+   if (!var->type->is_scalar() && !var->type->is_vector() &&
+       !var->type->is_matrix())
+      return false;
+
+   return this->writes->get_count(var) == 1;
+}
+
+/**
+ * Can \p rvalue get a value number?
+ *
+ * Constants and plain variable reads are left alone: replacing them with a
+ * read of another variable isn't a win.
+ */
+bool
+value_numbering::can_number(ir_rvalue *rvalue)
+{
+   switch (rvalue->ir_type) {
+   case ir_type_expression:
+   case ir_type_swizzle:
+   case ir_type_texture:
+   case ir_type_dereference_array:
+      break;
+   default:
+      return false;
+   }
+
+   invariant_visitor v(this->defs);
+   rvalue->accept(&v);
+   return v.invariant;
+}
+
+bool
+value_numbering::values_equal(const void *a, const void *b)
+{
+   return ((ir_rvalue *) a)->equals((ir_rvalue *) b);
+}
+
+void
+value_numbering::add_entry(ir_variable *var, ir_rvalue *value,
+                           uint32_t hash, ir_variable *leader)
+{
+   vn_entry *entry = new(this->mem_ctx) vn_entry(var, value, hash, leader,
+                                                 this->depth);
+
+   this->values.push_head(entry);
+   _mesa_hash_table_insert(this->defs, _mesa_hash_pointer(var), var, entry);
+   if (value)
+      _mesa_hash_table_insert(this->value_table, hash, value, entry);
+}
+
+void
+value_numbering::remove_entry(vn_entry *entry)
+{
+   struct hash_entry *e =
+      _mesa_hash_table_search(this->defs, _mesa_hash_pointer(entry->var),
+                              entry->var);
+   _mesa_hash_table_remove(this->defs, e);
+
+   /* Values that don't compare equal to themselves can't be found again,
+    * so they may be left behind.  process_assignment() ignores them.
+    */
+   if (entry->value) {
+      e = _mesa_hash_table_search(this->value_table, entry->hash,
+                                  entry->value);
+      if (e && e->data == entry)
+         _mesa_hash_table_remove(this->value_table, e);
+   }
+
+   entry->remove();
+}
+
+void
+value_numbering::rewrite(ir_instruction *ir)
+{
+   leader_rewriter v(this->defs);
+
+   ir->accept(&v);
+   this->progress = v.progress || this->progress;
+}
+
+void
+value_numbering::rewrite(ir_rvalue **rvalue)
+{
+   leader_rewriter v(this->defs);
+
+   (*rvalue)->accept(&v);
+   v.handle_rvalue(rvalue);
+   this->progress = v.progress || this->progress;
+}
+
+void
+value_numbering::process_assignment(ir_assignment *ir)
+{
+   rewrite(ir);
+
+   if (!is_candidate(ir))
+      return;
+
+   ir_variable *var = ir->lhs->variable_referenced();
+
+   /* A copy of another value: later reads can use the original. */
+   ir_dereference_variable *copy = ir->rhs->as_dereference_variable();
+   if (copy && copy->type == var->type &&
+       (is_read_only(copy->var) || find_def(this->defs, copy->var))) {
+      add_entry(var, NULL, 0, copy->var);
+      return;
+   }
+
+   if (!can_number(ir->rhs)) {
+      add_entry(var, NULL, 0, NULL);
+      return;
+   }
+
+   const uint32_t hash = hash_value(ir->rhs);
+   struct hash_entry *e =
+      _mesa_hash_table_search(this->value_table, hash, ir->rhs);
+
+   vn_entry *entry = e ? (vn_entry *) e->data : NULL;
+
+   /* The entry must still be in scope, see remove_entry(). */
+   if (entry == NULL || find_def(this->defs, entry->var) != entry) {
+      add_entry(var, ir->rhs, hash, NULL);
+      return;
+   }
+
+   if (debug) {
+      printf("value numbering: %s has the same value as %s\n",
+             var->name, entry->var->name);
+   }
+
+   ir->rhs = new(ralloc_parent(ir)) ir_dereference_variable(entry->var);
+   add_entry(var, NULL, 0, entry->var);
+   this->progress = true;
+}
+
+void
+value_numbering::process_list(exec_list *instructions)
+{
+   this->depth++;
+
+   foreach_in_list(ir_instruction, ir, instructions) {
+      switch (ir->ir_type) {
+      case ir_type_assignment:
+         process_assignment((ir_assignment *) ir);
+         break;
+
+      case ir_type_if: {
+         ir_if *iif = (ir_if *) ir;
+
+         rewrite(&iif->condition);
+         process_list(&iif->then_instructions);
+         process_list(&iif->else_instructions);
+         break;
+      }
+
+      case ir_type_loop:
+         process_list(&((ir_loop *) ir)->body_instructions);
+         break;
+
+      case ir_type_function:
+         this->in_function = true;
+         foreach_in_list(ir_function_signature, sig,
+                         &((ir_function *) ir)->signatures) {
+            process_list(&sig->body);
+         }
+         this->in_function = false;
+         break;
+
+      case ir_type_variable:
+         if (this->in_function) {
+            _mesa_hash_table_insert(this->locals, _mesa_hash_pointer(ir), ir,
+                                    ir);
+         }
+         break;
+
+      default:
+         rewrite(ir);
+         break;
+      }
+   }
+
+   /* Values defined in this list don't dominate anything after it. */
+   while (!this->values.is_empty()) {
+      vn_entry *entry = (vn_entry *) this->values.get_head();
+
+      if (entry->depth != this->depth)
+         break;
+
+      remove_entry(entry);
+   }
+
+   this->depth--;
+}
+
+bool
+do_value_numbering(exec_list *instructions)
+{
+   write_count_visitor writes;
+   writes.run(instructions);
+
+   value_numbering vn(&writes);
+   vn.process_list(instructions);
+
+   return vn.progress;
+}
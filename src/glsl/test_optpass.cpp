@@ -131,6 +131,8 @@ do_optimization(struct exec_list *ir, const char *optimization,
       return lower_quadop_vector(ir, int_0 != 0);
    } else if (strcmp(optimization, "optimize_redundant_jumps") == 0) {
       return optimize_redundant_jumps(ir);
+   } else if (strcmp(optimization, "do_value_numbering") == 0) {
+      return do_value_numbering(ir);
    } else {
       printf("Unrecognized optimization %s\n", optimization);
       exit(EXIT_FAILURE);
@@ -0,0 +1,259 @@
+# coding=utf-8
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice (including the next
+# paragraph) shall be included in all copies or substantial portions of the
+# Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+
+import os
+import os.path
+import re
+import subprocess
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), '..')) # For access to sexps.py, which is in parent dir
+from sexps import *
+
+def make_test_case(f_name, ret_type, body):
+    """Create a simple optimization test case consisting of a single
+    function with the given name, return type, and body.
+
+    Global declarations are automatically created for any undeclared
+    variables that are referenced by the function.  Variables that are
+    only read are declared as float shader inputs, assigned variables
+    as float shader outputs.
+    """
+    check_sexp(body)
+    declarations = {}
+    def make_declarations(sexp, already_declared = ()):
+        if isinstance(sexp, list):
+            if len(sexp) == 2 and sexp[0] == 'var_ref':
+                if sexp[1] not in already_declared:
+                    declarations[sexp[1]] = [
+                        'declare', ['shader_in'], 'float', sexp[1]]
+            elif len(sexp) == 4 and sexp[0] == 'assign':
+                assert sexp[2][0] == 'var_ref'
+                if sexp[2][1] not in already_declared:
+                    declarations[sexp[2][1]] = [
+                        'declare', ['shader_out'], 'float', sexp[2][1]]
+                make_declarations(sexp[3], already_declared)
+            else:
+                already_declared = set(already_declared)
+                for s in sexp:
+                    if isinstance(s, list) and len(s) >= 4 and \
+                            s[0] == 'declare':
+                        already_declared.add(s[3])
+                    else:
+                        make_declarations(s, already_declared)
+    make_declarations(body)
+    return declarations.values() + \
+        [['function', f_name, ['signature', ret_type, ['parameters'], body]]]
+
+
+# The following functions can be used to build expressions.
+
+def const_float(value):
+    """Create an expression representing the given floating point value."""
+    return ['constant', 'float', ['{0:.6f}'.format(value)]]
+
+def gt_zero(var_name):
+    """Create Construct the expression var_name > 0"""
+    return ['expression', 'bool', '>', ['var_ref', var_name], const_float(0)]
+
+def add(a, b):
+    """Create the expression a + b of two float variables."""
+    return ['expression', 'float', '+', ['var_ref', a], ['var_ref', b]]
+
+
+# The following functions can be used to build statements.  All of them
+# return statement lists, so that statements can be sequenced together
+# using the '+' operator.
+
+def simple_if(var_name, then_statements, else_statements = None):
+    """Create a statement of the form
+
+    if (var_name > 0.0) {
+       <then_statements>
+    } else {
+       <else_statements>
+    }
+
+    else_statements may be omitted.
+    """
+    if else_statements is None:
+        else_statements = []
+    check_sexp(then_statements)
+    check_sexp(else_statements)
+    return [['if', gt_zero(var_name), then_statements, else_statements]]
+
+def declare_temp(var_type, var_name):
+    """Create a declaration of the form
+
+    (declare (temporary) <var_type> <var_name)
+    """
+    return [['declare', ['temporary'], var_type, var_name]]
+
+def assign_x(var_name, value):
+    """Create a statement that assigns <value> to the variable
+    <var_name>.  The assignment uses the mask (x).
+    """
+    check_sexp(value)
+    return [['assign', ['x'], ['var_ref', var_name], value]]
+
+def bash_quote(*args):
+    """Quote the arguments appropriately so that bash will understand
+    each argument as a single word.
+    """
+    def quote_word(word):
+        for c in word:
+            if not (c.isalpha() or c.isdigit() or c in '@%_-+=:,./'):
+                break
+        else:
+            if not word:
+                return "''"
+            return word
+        return "'{0}'".format(word.replace("'", "'\"'\"'"))
+    return ' '.join(quote_word(word) for word in args)
+
+def create_test_case(doc_string, input_sexp, expected_sexp, test_name):
+    """Create a test case that verifies that do_value_numbering
+    transforms the given code in the expected way.
+    """
+    doc_lines = [line.strip() for line in doc_string.splitlines()]
+    doc_string = ''.join('# {0}\n'.format(line) for line in doc_lines if line != '')
+    check_sexp(input_sexp)
+    check_sexp(expected_sexp)
+    input_str = sexp_to_string(sort_decls(input_sexp))
+    expected_output = sexp_to_string(sort_decls(expected_sexp))
+
+    args = ['../../glsl_test', 'optpass', '--quiet', '--input-ir',
+            'do_value_numbering']
+    test_file = '{0}.opt_test'.format(test_name)
+    with open(test_file, 'w') as f:
+        f.write('#!/usr/bin/env bash\n#\n# This file was generated by create_test_cases.py.\n#\n')
+        f.write(doc_string)
+        f.write('{0} <<EOF\n'.format(bash_quote(*args)))
+        f.write('{0}\nEOF\n'.format(input_str))
+    os.chmod(test_file, 0774)
+    expected_file = '{0}.opt_test.expected'.format(test_name)
+    with open(expected_file, 'w') as f:
+        f.write('{0}\n'.format(expected_output))
+
+def test_redundant_expression():
+    doc_string = """Test that an expression which is recomputed into a
+    second temporary is replaced by a read of the first one, and that
+    reads of the second temporary are redirected to the first.
+    """
+    input_sexp = make_test_case('main', 'void', (
+            declare_temp('float', 't1') +
+            declare_temp('float', 't2') +
+            assign_x('t1', add('a', 'b')) +
+            assign_x('t2', add('a', 'b')) +
+            assign_x('x', ['var_ref', 't2'])
+            ))
+    expected_sexp = make_test_case('main', 'void', (
+            declare_temp('float', 't1') +
+            declare_temp('float', 't2') +
+            assign_x('t1', add('a', 'b')) +
+            assign_x('t2', ['var_ref', 't1']) +
+            assign_x('x', ['var_ref', 't1'])
+            ))
+    create_test_case(doc_string, input_sexp, expected_sexp,
+                     'redundant_expression')
+
+def test_redundant_expression_in_if():
+    doc_string = """Test that a value computed before an if-statement is
+    reused inside it, since its assignment dominates the if-statement.
+    """
+    input_sexp = make_test_case('main', 'void', (
+            declare_temp('float', 't1') +
+            declare_temp('float', 't2') +
+            assign_x('t1', add('a', 'b')) +
+            simple_if('c', assign_x('t2', add('a', 'b')) +
+                           assign_x('x', ['var_ref', 't2'])) +
+            assign_x('y', ['var_ref', 't1'])
+            ))
+    expected_sexp = make_test_case('main', 'void', (
+            declare_temp('float', 't1') +
+            declare_temp('float', 't2') +
+            assign_x('t1', add('a', 'b')) +
+            simple_if('c', assign_x('t2', ['var_ref', 't1']) +
+                           assign_x('x', ['var_ref', 't1'])) +
+            assign_x('y', ['var_ref', 't1'])
+            ))
+    create_test_case(doc_string, input_sexp, expected_sexp,
+                     'redundant_expression_in_if')
+
+def test_no_reuse_after_if():
+    doc_string = """Test that a value computed inside an if-statement is
+    not reused after it, since its assignment doesn't dominate the code
+    following the if-statement.
+    """
+    input_sexp = make_test_case('main', 'void', (
+            declare_temp('float', 't1') +
+            declare_temp('float', 't2') +
+            simple_if('c', assign_x('t1', add('a', 'b')) +
+                           assign_x('x', ['var_ref', 't1'])) +
+            assign_x('t2', add('a', 'b')) +
+            assign_x('y', ['var_ref', 't2'])
+            ))
+    create_test_case(doc_string, input_sexp, input_sexp,
+                     'no_reuse_after_if')
+
+def test_no_reuse_of_changed_operand():
+    doc_string = """Test that expressions reading a variable which is
+    written more than once aren't merged, since the variable may hold a
+    different value by the time the second expression is computed.
+    """
+    input_sexp = make_test_case('main', 'void', (
+            declare_temp('float', 'v') +
+            declare_temp('float', 't1') +
+            declare_temp('float', 't2') +
+            assign_x('v', ['var_ref', 'a']) +
+            assign_x('t1', add('v', 'b')) +
+            assign_x('v', ['var_ref', 'c']) +
+            assign_x('t2', add('v', 'b')) +
+            assign_x('x', ['var_ref', 't1']) +
+            assign_x('y', ['var_ref', 't2'])
+            ))
+    create_test_case(doc_string, input_sexp, input_sexp,
+                     'no_reuse_of_changed_operand')
+
+def test_no_reuse_of_global():
+    doc_string = """Test that a global variable isn't treated as a value
+    even if it is written only once, since other functions may read it
+    before the assignment.
+    """
+    input_sexp = make_test_case('main', 'void', (
+            declare_temp('float', 't') +
+            assign_x('g', add('a', 'b')) +
+            assign_x('t', add('a', 'b')) +
+            assign_x('x', ['var_ref', 't'])
+            ))
+    # Make g an ordinary global rather than a shader output.
+    input_sexp = [['declare', [], 'float', 'g']
+                  if s == ['declare', ['shader_out'], 'float', 'g'] else s
+                  for s in input_sexp]
+    create_test_case(doc_string, input_sexp, input_sexp,
+                     'no_reuse_of_global')
+
+if __name__ == '__main__':
+    test_redundant_expression()
+    test_redundant_expression_in_if()
+    test_no_reuse_after_if()
+    test_no_reuse_of_changed_operand()
+    test_no_reuse_of_global()
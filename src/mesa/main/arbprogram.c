@@ -41,6 +41,26 @@
 #include "program/prog_print.h"
 
 
+/**
+ * Flush vertices before a program env/local parameter update and flag the
+ * constants of the stage named by \p target as changed.
+ */
+static void
+flush_vertices_for_program_constants(struct gl_context *ctx, GLenum target)
+{
+   FLUSH_VERTICES(ctx, _NEW_PROGRAM_CONSTANTS);
+
+   if (target == GL_FRAGMENT_PROGRAM_ARB) {
+      ctx->NewDriverState |=
+         ctx->DriverFlags.NewShaderConstants[MESA_SHADER_FRAGMENT];
+   }
+   else {
+      ctx->NewDriverState |=
+         ctx->DriverFlags.NewShaderConstants[MESA_SHADER_VERTEX];
+   }
+}
+
+
 /**
  * Bind a program (make it current)
  * \note Called from the GL API dispatcher by both glBindProgramNV
@@ -415,7 +435,7 @@ _mesa_ProgramEnvParameter4fARB(GLenum target, GLuint index,
 
    GET_CURRENT_CONTEXT(ctx);
 
-   FLUSH_VERTICES(ctx, _NEW_PROGRAM_CONSTANTS);
+   flush_vertices_for_program_constants(ctx, target);
 
    if (get_env_param_pointer(ctx, "glProgramEnvParameter",
 			     target, index, &param)) {
@@ -437,7 +457,7 @@ _mesa_ProgramEnvParameter4fvARB(GLenum target, GLuint index,
 
    GET_CURRENT_CONTEXT(ctx);
 
-   FLUSH_VERTICES(ctx, _NEW_PROGRAM_CONSTANTS);
+   flush_vertices_for_program_constants(ctx, target);
 
    if (get_env_param_pointer(ctx, "glProgramEnvParameter4fv",
 			      target, index, &param)) {
@@ -453,7 +473,7 @@ _mesa_ProgramEnvParameters4fvEXT(GLenum target, GLuint index, GLsizei count,
    GET_CURRENT_CONTEXT(ctx);
    GLfloat * dest;
 
-   FLUSH_VERTICES(ctx, _NEW_PROGRAM_CONSTANTS);
+   flush_vertices_for_program_constants(ctx, target);
 
    if (count <= 0) {
       _mesa_error(ctx, GL_INVALID_VALUE, "glProgramEnvParameters4fv(count)");
@@ -520,7 +540,7 @@ _mesa_ProgramLocalParameter4fARB(GLenum target, GLuint index,
    GET_CURRENT_CONTEXT(ctx);
    GLfloat *param;
 
-   FLUSH_VERTICES(ctx, _NEW_PROGRAM_CONSTANTS);
+   flush_vertices_for_program_constants(ctx, target);
 
    if (get_local_param_pointer(ctx, "glProgramLocalParameterARB",
 			       target, index, &param)) {
@@ -546,7 +566,7 @@ _mesa_ProgramLocalParameters4fvEXT(GLenum target, GLuint index, GLsizei count,
    GET_CURRENT_CONTEXT(ctx);
    GLfloat *dest;
 
-   FLUSH_VERTICES(ctx, _NEW_PROGRAM_CONSTANTS);
+   flush_vertices_for_program_constants(ctx, target);
 
    if (count <= 0) {
       _mesa_error(ctx, GL_INVALID_VALUE, "glProgramLocalParameters4fv(count)");
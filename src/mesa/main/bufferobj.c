@@ -47,6 +47,7 @@
 #include "texstore.h"
 #include "transformfeedback.h"
 #include "dispatch.h"
+#include "vbo/vbo.h"
 
 
 /* Debug flags */
@@ -460,6 +461,9 @@ _mesa_reference_buffer_object_(struct gl_context *ctx,
 	 ASSERT(ctx->Array.VAO->Vertex.BufferObj != bufObj);
 #endif
 
+         vbo_delete_minmax_cache(oldObj);
+         mtx_destroy(&oldObj->MinMaxCacheMutex);
+
 	 ASSERT(ctx->Driver.DeleteBuffer);
          ctx->Driver.DeleteBuffer(ctx, oldObj);
       }
@@ -502,6 +506,7 @@ _mesa_initialize_buffer_object( struct gl_context *ctx,
 
    memset(obj, 0, sizeof(struct gl_buffer_object));
    mtx_init(&obj->Mutex, mtx_plain);
+   mtx_init(&obj->MinMaxCacheMutex, mtx_plain);
    obj->RefCount = 1;
    obj->Name = name;
    obj->Usage = GL_STATIC_DRAW_ARB;
@@ -957,6 +962,24 @@ bind_buffer_object(struct gl_context *ctx, GLenum target, GLuint buffer)
          return;
    }
    
+   /* record usages where the GPU may write to the buffer */
+   switch (target) {
+   case GL_PIXEL_PACK_BUFFER:
+      newBufObj->UsageHistory |= USAGE_PIXEL_PACK_BUFFER;
+      break;
+   case GL_TRANSFORM_FEEDBACK_BUFFER:
+      newBufObj->UsageHistory |= USAGE_TRANSFORM_FEEDBACK_BUFFER;
+      break;
+   case GL_ATOMIC_COUNTER_BUFFER:
+      newBufObj->UsageHistory |= USAGE_ATOMIC_COUNTER_BUFFER;
+      break;
+   case GL_TEXTURE_BUFFER:
+      newBufObj->UsageHistory |= USAGE_TEXTURE_BUFFER;
+      break;
+   default:
+      break;
+   }
+
    /* bind new buffer */
    _mesa_reference_buffer_object(ctx, bindTarget, newBufObj);
 }
@@ -1379,6 +1402,7 @@ _mesa_BufferStorage(GLenum target, GLsizeiptr size, const GLvoid *data,
 
    bufObj->Written = GL_TRUE;
    bufObj->Immutable = GL_TRUE;
+   bufObj->MinMaxCacheDirty = true;
 
    ASSERT(ctx->Driver.BufferData);
    if (!ctx->Driver.BufferData(ctx, target, size, data, GL_DYNAMIC_DRAW,
@@ -1451,6 +1475,7 @@ _mesa_BufferData(GLenum target, GLsizeiptrARB size,
    FLUSH_VERTICES(ctx, _NEW_BUFFER_OBJECT);
 
    bufObj->Written = GL_TRUE;
+   bufObj->MinMaxCacheDirty = true;
 
 #ifdef VBO_DEBUG
    printf("glBufferDataARB(%u, sz %ld, from %p, usage 0x%x)\n",
@@ -1497,6 +1522,7 @@ _mesa_BufferSubData(GLenum target, GLintptrARB offset,
       return;
 
    bufObj->Written = GL_TRUE;
+   bufObj->MinMaxCacheDirty = true;
 
    ASSERT(ctx->Driver.BufferSubData);
    ctx->Driver.BufferSubData( ctx, offset, size, data, bufObj );
@@ -1559,6 +1585,8 @@ _mesa_ClearBufferData(GLenum target, GLenum internalformat, GLenum format,
       return;
    }
 
+   bufObj->MinMaxCacheDirty = true;
+
    if (data == NULL) {
       /* clear to zeros, per the spec */
       ctx->Driver.ClearBufferSubData(ctx, 0, bufObj->Size,
@@ -1610,6 +1638,8 @@ _mesa_ClearBufferSubData(GLenum target, GLenum internalformat,
       return;
    }
 
+   bufObj->MinMaxCacheDirty = true;
+
    if (data == NULL) {
       /* clear to zeros, per the spec */
       if (size > 0) {
@@ -1713,8 +1743,10 @@ _mesa_MapBuffer(GLenum target, GLenum access)
       bufObj->Mappings[MAP_USER].AccessFlags = accessFlags;
    }
 
-   if (access == GL_WRITE_ONLY_ARB || access == GL_READ_WRITE_ARB)
+   if (access == GL_WRITE_ONLY_ARB || access == GL_READ_WRITE_ARB) {
       bufObj->Written = GL_TRUE;
+      bufObj->MinMaxCacheDirty = true;
+   }
 
 #ifdef VBO_DEBUG
    printf("glMapBufferARB(%u, sz %ld, access 0x%x)\n",
@@ -2027,6 +2059,8 @@ _mesa_CopyBufferSubData(GLenum readTarget, GLenum writeTarget,
       }
    }
 
+   dst->MinMaxCacheDirty = true;
+
    ctx->Driver.CopyBufferSubData(ctx, src, dst, readOffset, writeOffset, size);
 }
 
@@ -2176,6 +2210,13 @@ _mesa_MapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length,
       return bufObj->Mappings[MAP_USER].Pointer;
    }
 
+   if (access & GL_MAP_WRITE_BIT) {
+      bufObj->MinMaxCacheDirty = true;
+      /* Writes through a persistent mapping bypass the API entirely. */
+      if (access & GL_MAP_PERSISTENT_BIT)
+         bufObj->UsageHistory |= USAGE_PERSISTENT_WRITE_MAP;
+   }
+
    ASSERT(ctx->Driver.MapBufferRange);
    map = ctx->Driver.MapBufferRange(ctx, offset, length, access, bufObj,
                                     MAP_USER);
@@ -2757,6 +2798,7 @@ set_atomic_buffer_binding(struct gl_context *ctx,
                           GLsizeiptr size)
 {
    _mesa_reference_buffer_object(ctx, &binding->BufferObject, bufObj);
+   bufObj->UsageHistory |= USAGE_ATOMIC_COUNTER_BUFFER;
 
    if (bufObj == ctx->Shared->NullBufferObj) {
       binding->Offset = -1;
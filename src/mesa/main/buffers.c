@@ -448,7 +448,10 @@ updated_drawbuffers(struct gl_context *ctx)
 {
    FLUSH_VERTICES(ctx, _NEW_BUFFERS);
 
-   if (ctx->API == API_OPENGL_COMPAT && !ctx->Extensions.ARB_ES2_compatibility) {
+   /* The draw buffers affect completeness in the same cases as in
+    * _mesa_test_framebuffer_completeness().
+    */
+   if (_mesa_is_desktop_gl(ctx) && !ctx->Extensions.ARB_ES2_compatibility) {
       struct gl_framebuffer *fb = ctx->DrawBuffer;
 
       /* Flag the FBO as requiring validation. */
@@ -597,6 +600,12 @@ _mesa_readbuffer(struct gl_context *ctx, GLenum buffer, GLint bufferIndex)
    fb->ColorReadBuffer = buffer;
    fb->_ColorReadBufferIndex = bufferIndex;
 
+   /* The read buffer may affect completeness, see updated_drawbuffers(). */
+   if (_mesa_is_user_fbo(fb) &&
+       _mesa_is_desktop_gl(ctx) && !ctx->Extensions.ARB_ES2_compatibility) {
+      fb->_Status = 0;
+   }
+
    ctx->NewState |= _NEW_BUFFERS;
 }
 
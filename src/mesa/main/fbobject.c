@@ -1854,6 +1854,11 @@ _mesa_EGLImageTargetRenderbufferStorageOES(GLenum target, GLeglImageOES image)
    FLUSH_VERTICES(ctx, _NEW_BUFFERS);
 
    ctx->Driver.EGLImageTargetRenderbufferStorage(ctx, rb, image);
+
+   /* Invalidate the framebuffers the renderbuffer is attached in. */
+   if (rb->AttachedAnytime) {
+      _mesa_HashWalk(ctx->Shared->FrameBuffers, invalidate_rb, rb);
+   }
 }
 
 
@@ -290,6 +290,64 @@ swizzle_convert_try_memcpy(void *dst, GLenum dst_type, int num_dst_channels,
    return true;
 }
 
+#ifdef MESA_BIG_ENDIAN
+#define UBYTE4_SHIFT(chan) (8 * (3 - (chan)))
+#else
+#define UBYTE4_SHIFT(chan) (8 * (chan))
+#endif
+
+/**
+ * Attempts to perform the given swizzle-and-convert operation as a byte
+ * shuffle within 4-channel, 8-bit pixels
+ *
+ * This covers the most common texture upload conversions, such as between
+ * RGBA8 and BGRA8.  Each pixel is moved as a single 32-bit word rather than
+ * one channel at a time.  If the operation is not such a shuffle, it
+ * returns false and we fall back to the standard version below.
+ *
+ * The arguments are exactly the same as for _mesa_swizzle_and_convert
+ *
+ * \return  true if it successfully performed the swizzle-and-convert
+ *          operation, false otherwise
+ */
+static bool
+swizzle_convert_try_ubyte4(void *dst, GLenum dst_type, int num_dst_channels,
+                           const void *src, GLenum src_type, int num_src_channels,
+                           const uint8_t swizzle[4], bool normalized, int count)
+{
+   const uint8_t *typed_src = src;
+   uint8_t *typed_dst = dst;
+   unsigned shift[4];
+   int i;
+
+   if (src_type != GL_UNSIGNED_BYTE || dst_type != GL_UNSIGNED_BYTE)
+      return false;
+   if (num_src_channels != 4 || num_dst_channels != 4)
+      return false;
+
+   for (i = 0; i < 4; ++i) {
+      if (swizzle[i] > MESA_FORMAT_SWIZZLE_W)
+         return false;
+      shift[i] = UBYTE4_SHIFT(swizzle[i]);
+   }
+
+   for (i = 0; i < count; ++i) {
+      uint32_t s, d;
+
+      memcpy(&s, typed_src, 4);
+      d = ((s >> shift[0]) & 0xff) << UBYTE4_SHIFT(0) |
+          ((s >> shift[1]) & 0xff) << UBYTE4_SHIFT(1) |
+          ((s >> shift[2]) & 0xff) << UBYTE4_SHIFT(2) |
+          ((s >> shift[3]) & 0xff) << UBYTE4_SHIFT(3);
+      memcpy(typed_dst, &d, 4);
+
+      typed_src += 4;
+      typed_dst += 4;
+   }
+
+   return true;
+}
+
 /**
  * Represents a single instance of the standard swizzle-and-convert loop
  *
@@ -486,6 +544,11 @@ _mesa_swizzle_and_convert(void *void_dst, GLenum dst_type, int num_dst_channels,
                                   swizzle, normalized, count))
       return;
 
+   if (swizzle_convert_try_ubyte4(void_dst, dst_type, num_dst_channels,
+                                  void_src, src_type, num_src_channels,
+                                  swizzle, normalized, count))
+      return;
+
    swizzle_x = swizzle[0];
    swizzle_y = swizzle[1];
    swizzle_z = swizzle[2];
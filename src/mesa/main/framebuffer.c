@@ -659,8 +659,10 @@ update_framebuffer(struct gl_context *ctx, struct gl_framebuffer *fb)
    else {
       /* This is a user-created framebuffer.
        * Completeness only matters for user-created framebuffers.
+       * The status is reset to 0 ("indeterminate") by anything that can
+       * change it, so only test it then.
        */
-      if (fb->_Status != GL_FRAMEBUFFER_COMPLETE) {
+      if (fb->_Status == 0) {
          _mesa_test_framebuffer_completeness(ctx, fb);
       }
    }
@@ -40,18 +40,24 @@
 #include "util/hash_table.h"
 
 /**
- * Magic GLuint object name that gets stored outside of the struct hash_table.
+ * Magic GLuint object name that marks deleted entries in struct hash_table.
  *
  * The hash table needs a particular pointer to be the marker for a key that
  * was deleted from the table, along with NULL for the "never allocated in the
  * table" marker.  Legacy GL allows any GLuint to be used as a GL object name,
- * and we use a 1:1 mapping from GLuints to key pointers, so we need to be
- * able to track a GLuint that happens to match the deleted key outside of
- * struct hash_table.  We tell the hash table to use "1" as the deleted key
- * value, so that we test the deleted-key-in-the-table path as best we can.
+ * and we use a 1:1 mapping from GLuints to key pointers, so the deleted key
+ * must be a GLuint that is never stored in struct hash_table.  Names below
+ * DIRECT_KEYS live in the direct array instead, so "1" is safe to use.
  */
 #define DELETED_KEY_VALUE 1
 
+/**
+ * Object names below this are stored in a directly indexed array rather than
+ * in struct hash_table.  glGen*() hands out names counting up from 1, so this
+ * covers the objects of most applications.
+ */
+#define DIRECT_KEYS 1024
+
 /**
  * The hash table data structure.  
  */
@@ -61,10 +67,29 @@ struct _mesa_HashTable {
    mtx_t Mutex;                /**< mutual exclusion lock */
    mtx_t WalkMutex;            /**< for _mesa_HashWalk() */
    GLboolean InDeleteAll;                /**< Debug check */
-   /** Value that would be in the table for DELETED_KEY_VALUE. */
-   void *deleted_key_data;
+   /**
+    * Data for the names below DIRECT_KEYS, allocated on the first insertion
+    * of such a name.  Only written with Mutex held, but read without any
+    * lock so that looking up objects doesn't contend between threads.
+    */
+   void *volatile *volatile Direct;
 };
 
+/**
+ * Make everything written so far visible to other threads before whatever
+ * is written next, so that lock-free readers of the direct array never see
+ * a pointer before the data it points to.
+ */
+static inline void
+publish_barrier(void)
+{
+#if defined(__GNUC__)
+   __sync_synchronize();
+#elif defined(_MSC_VER)
+   _ReadWriteBarrier();
+#endif
+}
+
 /** @{
  * Mapping from our use of GLuint as both the key and the hash value to the
  * hash_table.h API
@@ -147,11 +172,12 @@ _mesa_DeleteHashTable(struct _mesa_HashTable *table)
 {
    assert(table);
 
-   if (_mesa_hash_table_next_entry(table->ht, NULL) != NULL) {
+   if (_mesa_HashNumEntries(table) != 0) {
       _mesa_problem(NULL, "In _mesa_DeleteHashTable, found non-freed data");
    }
 
    _mesa_hash_table_destroy(table->ht, NULL);
+   free((void *) table->Direct);
 
    mtx_destroy(&table->Mutex);
    mtx_destroy(&table->WalkMutex);
@@ -160,6 +186,20 @@ _mesa_DeleteHashTable(struct _mesa_HashTable *table)
 
 
 
+/**
+ * Lookup a name below DIRECT_KEYS.  Safe to call without the mutex.
+ */
+static inline void *
+_mesa_HashLookup_direct(const struct _mesa_HashTable *table, GLuint key)
+{
+   void *volatile *direct = table->Direct;
+
+   assert(key < DIRECT_KEYS);
+
+   return direct ? direct[key] : NULL;
+}
+
+
 /**
  * Lookup an entry in the hash table, without locking.
  * \sa _mesa_HashLookup
@@ -172,8 +212,8 @@ _mesa_HashLookup_unlocked(struct _mesa_HashTable *table, GLuint key)
    assert(table);
    assert(key);
 
-   if (key == DELETED_KEY_VALUE)
-      return table->deleted_key_data;
+   if (key < DIRECT_KEYS)
+      return _mesa_HashLookup_direct(table, key);
 
    entry = _mesa_hash_table_search(table->ht, uint_hash(key), uint_key(key));
    if (!entry)
@@ -185,6 +225,9 @@ _mesa_HashLookup_unlocked(struct _mesa_HashTable *table, GLuint key)
 
 /**
  * Lookup an entry in the hash table.
+ *
+ * Names below DIRECT_KEYS, which is what glGen*() hands out in practice,
+ * are looked up without taking the mutex.
  * 
  * \param table the hash table.
  * \param key the key.
@@ -196,6 +239,11 @@ _mesa_HashLookup(struct _mesa_HashTable *table, GLuint key)
 {
    void *res;
    assert(table);
+   assert(key);
+
+   if (key < DIRECT_KEYS)
+      return _mesa_HashLookup_direct(table, key);
+
    mtx_lock(&table->Mutex);
    res = _mesa_HashLookup_unlocked(table, key);
    mtx_unlock(&table->Mutex);
@@ -263,8 +311,18 @@ _mesa_HashInsert_unlocked(struct _mesa_HashTable *table, GLuint key, void *data)
    if (key > table->MaxKey)
       table->MaxKey = key;
 
-   if (key == DELETED_KEY_VALUE) {
-      table->deleted_key_data = data;
+   if (key < DIRECT_KEYS) {
+      if (!table->Direct) {
+         void *volatile *direct = calloc(DIRECT_KEYS, sizeof(void *));
+         if (!direct) {
+            _mesa_error_no_memory(__func__);
+            return;
+         }
+         publish_barrier();
+         table->Direct = direct;
+      }
+      publish_barrier();
+      table->Direct[key] = data;
    } else {
       entry = _mesa_hash_table_search(table->ht, hash, uint_key(key));
       if (entry) {
@@ -337,8 +395,9 @@ _mesa_HashRemove(struct _mesa_HashTable *table, GLuint key)
    }
 
    mtx_lock(&table->Mutex);
-   if (key == DELETED_KEY_VALUE) {
-      table->deleted_key_data = NULL;
+   if (key < DIRECT_KEYS) {
+      if (table->Direct)
+         table->Direct[key] = NULL;
    } else {
       entry = _mesa_hash_table_search(table->ht, uint_hash(key), uint_key(key));
       _mesa_hash_table_remove(table->ht, entry);
@@ -368,14 +427,20 @@ _mesa_HashDeleteAll(struct _mesa_HashTable *table,
    ASSERT(callback);
    mtx_lock(&table->Mutex);
    table->InDeleteAll = GL_TRUE;
+   if (table->Direct) {
+      GLuint key;
+      for (key = 1; key < DIRECT_KEYS; key++) {
+         void *data = table->Direct[key];
+         if (data) {
+            callback(key, data, userData);
+            table->Direct[key] = NULL;
+         }
+      }
+   }
    hash_table_foreach(table->ht, entry) {
       callback((uintptr_t)entry->key, entry->data, userData);
       _mesa_hash_table_remove(table->ht, entry);
    }
-   if (table->deleted_key_data) {
-      callback(DELETED_KEY_VALUE, table->deleted_key_data, userData);
-      table->deleted_key_data = NULL;
-   }
    table->InDeleteAll = GL_FALSE;
    mtx_unlock(&table->Mutex);
 }
@@ -399,6 +464,13 @@ _mesa_HashClone(const struct _mesa_HashTable *table)
 
    clonetable = _mesa_NewHashTable();
    assert(clonetable);
+   if (table->Direct) {
+      GLuint key;
+      for (key = 1; key < DIRECT_KEYS; key++) {
+         if (table->Direct[key])
+            _mesa_HashInsert(clonetable, key, table->Direct[key]);
+      }
+   }
    hash_table_foreach(table->ht, entry) {
       _mesa_HashInsert(clonetable, (GLint)(uintptr_t)entry->key, entry->data);
    }
@@ -433,11 +505,17 @@ _mesa_HashWalk(const struct _mesa_HashTable *table,
    ASSERT(table);
    ASSERT(callback);
    mtx_lock(&table2->WalkMutex);
+   if (table->Direct) {
+      GLuint key;
+      for (key = 1; key < DIRECT_KEYS; key++) {
+         void *data = table->Direct[key];
+         if (data)
+            callback(key, data, userData);
+      }
+   }
    hash_table_foreach(table->ht, entry) {
       callback((uintptr_t)entry->key, entry->data, userData);
    }
-   if (table->deleted_key_data)
-      callback(DELETED_KEY_VALUE, table->deleted_key_data, userData);
    mtx_unlock(&table2->WalkMutex);
 }
 
@@ -455,8 +533,6 @@ debug_print_entry(GLuint key, void *data, void *userData)
 void
 _mesa_HashPrint(const struct _mesa_HashTable *table)
 {
-   if (table->deleted_key_data)
-      debug_print_entry(DELETED_KEY_VALUE, table->deleted_key_data, NULL);
    _mesa_HashWalk(table, debug_print_entry, NULL);
 }
 
@@ -520,8 +596,13 @@ _mesa_HashNumEntries(const struct _mesa_HashTable *table)
    struct hash_entry *entry;
    GLuint count = 0;
 
-   if (table->deleted_key_data)
-      count++;
+   if (table->Direct) {
+      GLuint key;
+      for (key = 1; key < DIRECT_KEYS; key++) {
+         if (table->Direct[key])
+            count++;
+      }
+   }
 
    hash_table_foreach(table->ht, entry)
       count++;
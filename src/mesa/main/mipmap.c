@@ -167,10 +167,21 @@ do_row(GLenum datatype, GLuint comps, GLint srcWidth,
       GLubyte(*dst)[4] = (GLubyte(*)[4]) dstRow;
       for (i = j = 0, k = k0; i < (GLuint) dstWidth;
            i++, j += colStride, k += colStride) {
-         dst[i][0] = (rowA[j][0] + rowA[k][0] + rowB[j][0] + rowB[k][0]) / 4;
-         dst[i][1] = (rowA[j][1] + rowA[k][1] + rowB[j][1] + rowB[k][1]) / 4;
-         dst[i][2] = (rowA[j][2] + rowA[k][2] + rowB[j][2] + rowB[k][2]) / 4;
-         dst[i][3] = (rowA[j][3] + rowA[k][3] + rowB[j][3] + rowB[k][3]) / 4;
+         /* Average all four channels at once: the even and the odd bytes
+          * of the four texels are summed in separate 16-bit lanes, which
+          * cannot overflow, then divided by four.
+          */
+         GLuint a0, a1, b0, b1, even, odd, texel;
+         memcpy(&a0, rowA[j], 4);
+         memcpy(&a1, rowA[k], 4);
+         memcpy(&b0, rowB[j], 4);
+         memcpy(&b1, rowB[k], 4);
+         even = (a0 & 0x00ff00ff) + (a1 & 0x00ff00ff) +
+                (b0 & 0x00ff00ff) + (b1 & 0x00ff00ff);
+         odd = ((a0 >> 8) & 0x00ff00ff) + ((a1 >> 8) & 0x00ff00ff) +
+               ((b0 >> 8) & 0x00ff00ff) + ((b1 >> 8) & 0x00ff00ff);
+         texel = ((even >> 2) & 0x00ff00ff) | (((odd >> 2) & 0x00ff00ff) << 8);
+         memcpy(dst[i], &texel, 4);
       }
    }
    else if (datatype == GL_UNSIGNED_BYTE && comps == 3) {
@@ -1215,6 +1215,7 @@ struct gl_texture_object
    GLboolean GenerateMipmap;   /**< GL_SGIS_generate_mipmap */
    GLboolean _BaseComplete;    /**< Is the base texture level valid? */
    GLboolean _MipmapComplete;  /**< Is the whole mipmap valid? */
+   GLboolean _CompletenessValid; /**< Are the two flags above up to date? */
    GLboolean _IsIntegerFormat; /**< Does the texture store integer values? */
    GLboolean _RenderToTexture; /**< Any rendering to this texture? */
    GLboolean Purgeable;        /**< Is the buffer purgeable under memory
@@ -1464,6 +1465,20 @@ struct gl_buffer_mapping {
 };
 
 
+/**
+ * Usage history of a buffer object.  Each bit is set once the buffer has
+ * been used in the given way and is never cleared.
+ */
+typedef enum {
+   USAGE_TEXTURE_BUFFER = 0x1,
+   USAGE_ATOMIC_COUNTER_BUFFER = 0x2,
+   USAGE_TRANSFORM_FEEDBACK_BUFFER = 0x4,
+   USAGE_PIXEL_PACK_BUFFER = 0x8,
+   USAGE_PERSISTENT_WRITE_MAP = 0x10,
+   USAGE_DISABLE_MINMAX_CACHE = 0x20
+} gl_buffer_usage;
+
+
 /**
  * GL_ARB_vertex/pixel_buffer_object buffer object
  */
@@ -1481,6 +1496,14 @@ struct gl_buffer_object
    GLboolean Written;   /**< Ever written to? (for debugging) */
    GLboolean Purgeable; /**< Is the buffer purgeable under memory pressure? */
    GLboolean Immutable; /**< GL_ARB_buffer_storage */
+   GLbitfield UsageHistory; /**< Mask of USAGE_x flags */
+
+   /** Memoization of min/max index computations for static index buffers */
+   struct hash_table *MinMaxCache;
+   unsigned MinMaxCacheHitIndices;
+   unsigned MinMaxCacheMissIndices;
+   bool MinMaxCacheDirty;
+   mtx_t MinMaxCacheMutex;
 
    struct gl_buffer_mapping Mappings[MAP_COUNT];
 };
@@ -2829,6 +2852,7 @@ struct gl_shader_program
 #define GLSL_USE_PROG 0x80  /**< Log glUseProgram calls */
 #define GLSL_REPORT_ERRORS 0x100  /**< Print compilation errors */
 #define GLSL_DUMP_ON_ERROR 0x200 /**< Dump shaders to stderr on compile error */
+#define GLSL_PARALLEL_LINK 0x400 /**< Optimize linked stages on worker threads */
 
 
 /**
@@ -3948,6 +3972,12 @@ struct gl_driver_flags
     * gl_context::ImageUnits
     */
    uint64_t NewImageUnits;
+
+   /**
+    * gl_program::Parameters of the program bound to each shader stage
+    * (uniforms, program env/local parameters and state variables)
+    */
+   uint64_t NewShaderConstants[MESA_SHADER_STAGES];
 };
 
 struct gl_uniform_buffer_binding
@@ -93,6 +93,8 @@ _mesa_get_shader_flags(void)
          flags |= GLSL_USE_PROG;
       if (strstr(env, "errors"))
          flags |= GLSL_REPORT_ERRORS;
+      if (strstr(env, "parallel"))
+         flags |= GLSL_PARALLEL_LINK;
    }
 
    return flags;
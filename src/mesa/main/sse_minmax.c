@@ -0,0 +1,91 @@
+/*
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *
+ */
+
+#ifdef __SSE4_1__
+#include "main/sse_minmax.h"
+#include <smmintrin.h>
+#include <stdint.h>
+
+void
+_mesa_uint_array_min_max(const unsigned *ui_indices, unsigned *min_index,
+                         unsigned *max_index, const unsigned count)
+{
+   unsigned max_ui = 0;
+   unsigned min_ui = ~0U;
+   unsigned i = 0;
+   unsigned aligned_count = count;
+
+   /* Handle the misaligned head one index at a time.  At the end of this
+    * loop, ui_indices + i is aligned to a 16-byte boundary or i == count.
+    */
+   while ((((uintptr_t) (ui_indices + i)) & 15) && i < count) {
+      if (ui_indices[i] > max_ui) max_ui = ui_indices[i];
+      if (ui_indices[i] < min_ui) min_ui = ui_indices[i];
+      i++;
+   }
+
+   aligned_count = i + ((count - i) & ~7U);
+
+   if (i < aligned_count) {
+      __m128i max_0 = _mm_set1_epi32(max_ui);
+      __m128i max_1 = max_0;
+      __m128i min_0 = _mm_set1_epi32(min_ui);
+      __m128i min_1 = min_0;
+      unsigned max_arr[4];
+      unsigned min_arr[4];
+      unsigned j;
+
+      /* Two independent accumulators per result to hide the PMINUD/PMAXUD
+       * latency.
+       */
+      for (; i < aligned_count; i += 8) {
+         __m128i data_0 = _mm_load_si128((const __m128i *) &ui_indices[i]);
+         __m128i data_1 = _mm_load_si128((const __m128i *) &ui_indices[i + 4]);
+         max_0 = _mm_max_epu32(max_0, data_0);
+         min_0 = _mm_min_epu32(min_0, data_0);
+         max_1 = _mm_max_epu32(max_1, data_1);
+         min_1 = _mm_min_epu32(min_1, data_1);
+      }
+
+      max_0 = _mm_max_epu32(max_0, max_1);
+      min_0 = _mm_min_epu32(min_0, min_1);
+
+      _mm_storeu_si128((__m128i *) max_arr, max_0);
+      _mm_storeu_si128((__m128i *) min_arr, min_0);
+
+      for (j = 0; j < 4; j++) {
+         if (max_arr[j] > max_ui) max_ui = max_arr[j];
+         if (min_arr[j] < min_ui) min_ui = min_arr[j];
+      }
+   }
+
+   /* Handle the tail. */
+   for (; i < count; i++) {
+      if (ui_indices[i] > max_ui) max_ui = ui_indices[i];
+      if (ui_indices[i] < min_ui) min_ui = ui_indices[i];
+   }
+
+   *min_index = min_ui;
+   *max_index = max_ui;
+}
+
+#endif
@@ -230,6 +230,8 @@ update_program(struct gl_context *ctx)
 
 /**
  * Examine shader constants and return either _NEW_PROGRAM_CONSTANTS or 0.
+ * The driver's per-stage constant flags are raised for each stage whose
+ * state-tracked parameters changed.
  */
 static GLbitfield
 update_program_constants(struct gl_context *ctx)
@@ -241,6 +243,8 @@ update_program_constants(struct gl_context *ctx)
          ctx->FragmentProgram._Current->Base.Parameters;
       if (params && params->StateFlags & ctx->NewState) {
          new_state |= _NEW_PROGRAM_CONSTANTS;
+         ctx->NewDriverState |=
+            ctx->DriverFlags.NewShaderConstants[MESA_SHADER_FRAGMENT];
       }
    }
 
@@ -251,6 +255,8 @@ update_program_constants(struct gl_context *ctx)
        *       not state changes */
       if (params /*&& params->StateFlags & ctx->NewState*/) {
          new_state |= _NEW_PROGRAM_CONSTANTS;
+         ctx->NewDriverState |=
+            ctx->DriverFlags.NewShaderConstants[MESA_SHADER_GEOMETRY];
       }
    }
 
@@ -259,6 +265,8 @@ update_program_constants(struct gl_context *ctx)
          ctx->VertexProgram._Current->Base.Parameters;
       if (params && params->StateFlags & ctx->NewState) {
          new_state |= _NEW_PROGRAM_CONSTANTS;
+         ctx->NewDriverState |=
+            ctx->DriverFlags.NewShaderConstants[MESA_SHADER_VERTEX];
       }
    }
 
@@ -0,0 +1,148 @@
+/*
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * \name minmax_cache.cpp
+ *
+ * Verify that the per-buffer cache of index ranges used by indexed draws
+ * is invalidated by every way of writing new contents into the buffer.
+ */
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "GL/gl.h"
+#include "GL/glext.h"
+#include "main/compiler.h"
+#include "main/bufferobj.h"
+#include "main/context.h"
+#include "drivers/common/driverfuncs.h"
+#include "vbo/vbo.h"
+}
+
+class MinMaxCache_test : public ::testing::Test {
+public:
+   virtual void SetUp();
+   virtual void TearDown();
+
+   void get_range(GLuint count, GLuint *min, GLuint *max);
+
+   struct gl_config visual;
+   struct dd_function_table driver_functions;
+   struct gl_context ctx;
+   GLuint buffer;
+};
+
+void
+MinMaxCache_test::SetUp()
+{
+   memset(&visual, 0, sizeof(visual));
+   memset(&driver_functions, 0, sizeof(driver_functions));
+   memset(&ctx, 0, sizeof(ctx));
+
+   _mesa_init_driver_functions(&driver_functions);
+   _mesa_initialize_context(&ctx,
+                            API_OPENGL_COMPAT,
+                            &visual,
+                            NULL, // share_list
+                            &driver_functions);
+   _vbo_CreateContext(&ctx);
+   _mesa_make_current(&ctx, NULL, NULL);
+
+   _mesa_GenBuffers(1, &buffer);
+   _mesa_BindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+}
+
+void
+MinMaxCache_test::TearDown()
+{
+   _mesa_DeleteBuffers(1, &buffer);
+   _mesa_make_current(NULL, NULL, NULL);
+   _vbo_DestroyContext(&ctx);
+   _mesa_free_context_data(&ctx);
+}
+
+/**
+ * Compute the index range of a glDrawElements(GL_TRIANGLES, count,
+ * GL_UNSIGNED_SHORT, 0) call from the bound element array buffer, the way
+ * the draw path does.
+ */
+void
+MinMaxCache_test::get_range(GLuint count, GLuint *min, GLuint *max)
+{
+   struct _mesa_prim prim;
+   struct _mesa_index_buffer ib;
+
+   memset(&prim, 0, sizeof(prim));
+   prim.mode = GL_TRIANGLES;
+   prim.start = 0;
+   prim.count = count;
+   prim.indexed = 1;
+
+   ib.count = count;
+   ib.type = GL_UNSIGNED_SHORT;
+   ib.obj = ctx.Array.VAO->IndexBufferObj;
+   ib.ptr = NULL;
+
+   vbo_get_minmax_indices(&ctx, &prim, &ib, min, max, 1);
+}
+
+TEST_F(MinMaxCache_test, BufferDataInvalidates)
+{
+   static const GLushort first[] = { 0, 1, 2 };
+   static const GLushort second[] = { 5, 9, 7 };
+   GLuint min, max;
+
+   _mesa_BufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(first), first,
+                    GL_STATIC_DRAW);
+
+   /* The second draw is answered from the cache. */
+   get_range(3, &min, &max);
+   get_range(3, &min, &max);
+   EXPECT_EQ(0u, min);
+   EXPECT_EQ(2u, max);
+
+   /* Re-specifying the buffer must not return the old range. */
+   _mesa_BufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(second), second,
+                    GL_STATIC_DRAW);
+   get_range(3, &min, &max);
+   EXPECT_EQ(5u, min);
+   EXPECT_EQ(9u, max);
+}
+
+TEST_F(MinMaxCache_test, BufferSubDataInvalidates)
+{
+   static const GLushort first[] = { 0, 1, 2 };
+   static const GLushort second[] = { 3, 4, 8 };
+   GLuint min, max;
+
+   _mesa_BufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(first), first,
+                    GL_STATIC_DRAW);
+   get_range(3, &min, &max);
+   get_range(3, &min, &max);
+   EXPECT_EQ(0u, min);
+   EXPECT_EQ(2u, max);
+
+   _mesa_BufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(second), second);
+   get_range(3, &min, &max);
+   EXPECT_EQ(3u, min);
+   EXPECT_EQ(8u, max);
+}
@@ -1035,7 +1035,7 @@ get_rgba_endpoints_unorm(int width, int height,
          for (i = 0; i < 3; i++)
             sums[endpoint][i] += p[i];
 
-         if (p[2] < average_alpha) {
+         if (p[3] < average_alpha) {
             endpoint = 0;
             alpha_left_endpoint_count++;
          } else {
@@ -1101,6 +1101,29 @@ get_rgba_endpoints_unorm(int width, int height,
    }
 }
 
+/**
+ * Return the index of the interpolation step nearest to \p value, for
+ * \p max_index + 1 evenly spaced steps going from 0 to \p range.  The
+ * range may be negative.
+ */
+static int
+get_nearest_index(int value, int range, int max_index)
+{
+   int index;
+
+   if (range < 0) {
+      value = -value;
+      range = -range;
+   }
+
+   if (value <= 0)
+      return 0;
+
+   index = (value * max_index * 2 + range) / (range * 2);
+
+   return MIN2(index, max_index);
+}
+
 static void
 write_rgb_indices_unorm(struct bit_writer *writer,
                         int src_width, int src_height,
@@ -1131,14 +1154,15 @@ write_rgb_indices_unorm(struct bit_writer *writer,
       for (x = 0; x < src_width; x++) {
          luminance = src[0] + src[1] + src[2];
 
-         index = ((luminance - endpoint_luminances[0]) * 3 /
-                  (endpoint_luminances[1] - endpoint_luminances[0]));
-         if (index < 0)
-            index = 0;
-         else if (index > 3)
-            index = 3;
+         index = get_nearest_index(luminance - endpoint_luminances[0],
+                                   endpoint_luminances[1] -
+                                   endpoint_luminances[0],
+                                   3);
 
-         assert(x != 0 || y != 0 || index < 2);
+         /* The endpoints were ordered so that the first texel is nearer to
+          * the first one.  Only a texel exactly half way can round up. */
+         if (x == 0 && y == 0 && index > 1)
+            index = 1;
 
          write_bits(writer, (x == 0 && y == 0) ? 1 : 2, index);
 
@@ -1175,14 +1199,13 @@ write_alpha_indices_unorm(struct bit_writer *writer,
 
    for (y = 0; y < src_height; y++) {
       for (x = 0; x < src_width; x++) {
-         index = (((int) src[3] - (int) endpoints[0][3]) * 7 /
-                  ((int) endpoints[1][3] - endpoints[0][3]));
-         if (index < 0)
-            index = 0;
-         else if (index > 7)
-            index = 7;
+         index = get_nearest_index((int) src[3] - (int) endpoints[0][3],
+                                   (int) endpoints[1][3] - endpoints[0][3],
+                                   7);
 
-         assert(x != 0 || y != 0 || index < 4);
+         /* The first index has one less bit, see above */
+         if (x == 0 && y == 0 && index > 3)
+            index = 3;
 
          /* The first index has one less bit */
          write_bits(writer, (x == 0 && y == 0) ? 2 : 3, index);
@@ -1226,14 +1249,15 @@ compress_rgba_unorm_block(int src_width, int src_height,
    write_bits(&writer, 2, 0); /* rotation 0 */
    write_bits(&writer, 1, 0); /* index selection bit */
 
-   /* Write the color endpoints */
+   /* Write the color endpoints, rounded to the nearest 5-bit value */
    for (component = 0; component < 3; component++)
       for (endpoint = 0; endpoint < 2; endpoint++)
-         write_bits(&writer, 5, endpoints[endpoint][component] >> 3);
+         write_bits(&writer, 5,
+                    (endpoints[endpoint][component] * 31 + 127) / 255);
 
-   /* Write the alpha endpoints */
+   /* Write the alpha endpoints, rounded to the nearest 6-bit value */
    for (endpoint = 0; endpoint < 2; endpoint++)
-      write_bits(&writer, 6, endpoints[endpoint][3] >> 2);
+      write_bits(&writer, 6, (endpoints[endpoint][3] * 63 + 127) / 255);
 
    write_rgb_indices_unorm(&writer,
                            src_width, src_height,
@@ -1262,6 +1262,8 @@ static void
 clear_teximage_fields(struct gl_texture_image *img)
 {
    ASSERT(img);
+   if (img->TexObject)
+      img->TexObject->_CompletenessValid = GL_FALSE;
    img->_BaseFormat = 0;
    img->InternalFormat = 0;
    img->Border = 0;
@@ -1311,6 +1313,10 @@ init_teximage_fields_ms(struct gl_context *ctx,
    ASSERT(height >= 0);
    ASSERT(depth >= 0);
 
+   /* The texture's completeness has to be determined again. */
+   if (img->TexObject)
+      img->TexObject->_CompletenessValid = GL_FALSE;
+
    target = img->TexObject->Target;
    img->_BaseFormat = _mesa_base_tex_format( ctx, internalFormat );
    ASSERT(img->_BaseFormat > 0);
@@ -3452,6 +3458,7 @@ _mesa_EGLImageTargetTexture2DOES (GLenum target, GLeglImageOES image)
 					  texObj, texImage, image);
 
       _mesa_dirty_texobj(ctx, texObj);
+      _mesa_update_fbo_texture(ctx, texObj, 0, 0);
    }
    _mesa_unlock_texture(ctx, texObj);
 
@@ -4643,6 +4650,9 @@ texbufferrange(struct gl_context *ctx, GLenum target, GLenum internalFormat,
 
    texObj = _mesa_get_current_tex_object(ctx, target);
 
+   if (bufObj)
+      bufObj->UsageHistory |= USAGE_TEXTURE_BUFFER;
+
    _mesa_lock_texture(ctx, texObj);
    {
       _mesa_reference_buffer_object(ctx, &texObj->BufferObject, bufObj);
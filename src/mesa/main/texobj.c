@@ -310,6 +310,7 @@ _mesa_copy_texture_object( struct gl_texture_object *dest,
    dest->GenerateMipmap = src->GenerateMipmap;
    dest->_BaseComplete = src->_BaseComplete;
    dest->_MipmapComplete = src->_MipmapComplete;
+   dest->_CompletenessValid = GL_FALSE;
    COPY_4V(dest->Swizzle, src->Swizzle);
    dest->_Swizzle = src->_Swizzle;
 
@@ -485,6 +486,11 @@ incomplete(struct gl_texture_object *t, enum base_mipmap bm,
  *
  * According to the texture target, verifies that each of the mipmaps is
  * present and has the expected size.
+ *
+ * The result is kept until the texture's images or completeness-related
+ * parameters change (see _mesa_dirty_texobj() and the teximage field
+ * setup functions), so incomplete textures aren't re-examined on every
+ * state validation.
  */
 void
 _mesa_test_texobj_completeness( const struct gl_context *ctx,
@@ -494,6 +500,11 @@ _mesa_test_texobj_completeness( const struct gl_context *ctx,
    const struct gl_texture_image *baseImage;
    GLint maxLevels = 0;
 
+   if (t->_CompletenessValid)
+      return;
+
+   t->_CompletenessValid = GL_TRUE;
+
    /* We'll set these to FALSE if tests fail below */
    t->_BaseComplete = GL_TRUE;
    t->_MipmapComplete = GL_TRUE;
@@ -757,6 +768,7 @@ _mesa_dirty_texobj(struct gl_context *ctx, struct gl_texture_object *texObj)
 {
    texObj->_BaseComplete = GL_FALSE;
    texObj->_MipmapComplete = GL_FALSE;
+   texObj->_CompletenessValid = GL_FALSE;
    ctx->NewState |= _NEW_TEXTURE;
 }
 
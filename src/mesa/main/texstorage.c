@@ -158,6 +158,27 @@ initialize_texture_fields(struct gl_context *ctx,
 }
 
 
+/**
+ * The texture may already be attached to framebuffer objects, whose
+ * completeness depends on the images we've just created.
+ */
+static void
+update_fbo_texture(struct gl_context *ctx,
+                   struct gl_texture_object *texObj,
+                   GLint levels)
+{
+   const GLuint numFaces = _mesa_num_tex_faces(texObj->Target);
+   GLint level;
+   GLuint face;
+
+   for (level = 0; level < levels; level++) {
+      for (face = 0; face < numFaces; face++) {
+         _mesa_update_fbo_texture(ctx, texObj, face, level);
+      }
+   }
+}
+
+
 /**
  * Clear all fields of texture object to zeros.  Used for proxy texture tests
  * and to clean up when a texture memory allocation fails.
@@ -451,6 +472,7 @@ texstorage(GLuint dims, GLenum target, GLsizei levels, GLenum internalformat,
 
       _mesa_set_texture_view_state(ctx, texObj, target, levels);
 
+      update_fbo_texture(ctx, texObj, levels);
    }
 }
 
@@ -600,6 +600,22 @@ _mesa_propagate_uniforms_to_driver_storage(struct gl_uniform_storage *uni,
    }
 }
 
+/**
+ * Flush vertices before a uniform update and flag the constants of every
+ * stage of \c shProg as changed.
+ */
+static void
+flush_vertices_for_uniforms(struct gl_context *ctx,
+                            const struct gl_shader_program *shProg)
+{
+   FLUSH_VERTICES(ctx, _NEW_PROGRAM_CONSTANTS);
+
+   for (unsigned i = 0; i < MESA_SHADER_STAGES; i++) {
+      if (shProg->_LinkedShaders[i])
+         ctx->NewDriverState |= ctx->DriverFlags.NewShaderConstants[i];
+   }
+}
+
 /**
  * Called via glUniform*() functions.
  */
@@ -783,7 +799,22 @@ _mesa_uniform(struct gl_context *ctx, struct gl_shader_program *shProg,
       count = MIN2(count, (int) (uni->array_elements - offset));
    }
 
-   FLUSH_VERTICES(ctx, _NEW_PROGRAM_CONSTANTS);
+   /* Applications often set the same values again for every draw.  If
+    * nothing changes, don't flush vertices or make the driver upload the
+    * constants again.  Samplers and images have side effects below, and
+    * booleans are converted before being stored, so always take the
+    * slow path for those.
+    */
+   if (!uni->type->is_boolean() &&
+       !uni->type->is_sampler() &&
+       !uni->type->is_image() &&
+       memcmp(&uni->storage[components * offset], values,
+              sizeof(uni->storage[0]) * components * count) == 0) {
+      uni->initialized = true;
+      return;
+   }
+
+   flush_vertices_for_uniforms(ctx, shProg);
 
    /* Store the data in the "actual type" backing storage for the uniform.
     */
@@ -955,11 +986,20 @@ _mesa_uniform_matrix(struct gl_context *ctx, struct gl_shader_program *shProg,
       count = MIN2(count, (int) (uni->array_elements - offset));
    }
 
-   FLUSH_VERTICES(ctx, _NEW_PROGRAM_CONSTANTS);
+   elements = components * vectors;
+
+   /* Nothing to do if the values don't change, see _mesa_uniform(). */
+   if (!transpose &&
+       memcmp(&uni->storage[elements * offset], values,
+              sizeof(uni->storage[0]) * elements * count) == 0) {
+      uni->initialized = true;
+      return;
+   }
+
+   flush_vertices_for_uniforms(ctx, shProg);
 
    /* Store the data in the "actual type" backing storage for the uniform.
     */
-   elements = components * vectors;
 
    if (!transpose) {
       memcpy(&uni->storage[elements * offset], values,
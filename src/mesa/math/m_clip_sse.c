@@ -0,0 +1,179 @@
+/*
+ * Mesa 3-D graphics library
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * \file m_clip_sse.c
+ * SSE2 versions of the 4-component cliptest functions.
+ *
+ * The outcodes of a vertex are computed with two packed compares instead
+ * of six scalar compares and branches.  The results are identical to the
+ * C versions in m_clip_tmp.h.
+ */
+
+#ifdef __SSE2__
+
+#include <emmintrin.h>
+
+#include "main/glheader.h"
+#include "main/macros.h"
+#include "m_xform.h"
+
+
+/**
+ * Outcode bits for the (x, y, z) lanes of a "w < coord" compare and of a
+ * "w < -coord" compare, indexed by the _mm_movemask_ps() result.
+ */
+static const GLubyte pos_clip_bits[8] = {
+   0,
+   CLIP_RIGHT_BIT,
+   CLIP_TOP_BIT,
+   CLIP_RIGHT_BIT | CLIP_TOP_BIT,
+   CLIP_FAR_BIT,
+   CLIP_FAR_BIT | CLIP_RIGHT_BIT,
+   CLIP_FAR_BIT | CLIP_TOP_BIT,
+   CLIP_FAR_BIT | CLIP_RIGHT_BIT | CLIP_TOP_BIT
+};
+
+static const GLubyte neg_clip_bits[8] = {
+   0,
+   CLIP_LEFT_BIT,
+   CLIP_BOTTOM_BIT,
+   CLIP_LEFT_BIT | CLIP_BOTTOM_BIT,
+   CLIP_NEAR_BIT,
+   CLIP_NEAR_BIT | CLIP_LEFT_BIT,
+   CLIP_NEAR_BIT | CLIP_BOTTOM_BIT,
+   CLIP_NEAR_BIT | CLIP_LEFT_BIT | CLIP_BOTTOM_BIT
+};
+
+
+/**
+ * Compute the frustum outcode of clip-space vertex 'v'.
+ * 'w < c' is equivalent to the C versions' '-c + w < 0', and 'w < -c' to
+ * 'c + w < 0', since the sign of an IEEE sum or difference is exact.
+ */
+static inline GLubyte
+clip_mask_sse(__m128 v, __m128 w, GLubyte zmask)
+{
+   const __m128 neg = _mm_sub_ps(_mm_setzero_ps(), v);
+   const int pos_bits = _mm_movemask_ps(_mm_cmplt_ps(w, v)) & 0x7;
+   const int neg_bits = _mm_movemask_ps(_mm_cmplt_ps(w, neg)) & 0x7;
+
+   return (pos_clip_bits[pos_bits] | neg_clip_bits[neg_bits]) & zmask;
+}
+
+
+static GLvector4f * _XFORMAPI
+sse_cliptest_points4(GLvector4f *clip_vec,
+                     GLvector4f *proj_vec,
+                     GLubyte clipMask[],
+                     GLubyte *orMask,
+                     GLubyte *andMask,
+                     GLboolean viewport_z_clip)
+{
+   const GLuint stride = clip_vec->stride;
+   const GLfloat *from = (GLfloat *)clip_vec->start;
+   const GLuint count = clip_vec->count;
+   const GLubyte zmask = viewport_z_clip ?
+      CLIP_FRUSTUM_BITS : CLIP_FRUSTUM_BITS & ~(CLIP_NEAR_BIT | CLIP_FAR_BIT);
+   GLuint c = 0;
+   GLfloat (*vProj)[4] = (GLfloat (*)[4])proj_vec->start;
+   GLubyte tmpAndMask = *andMask;
+   GLubyte tmpOrMask = *orMask;
+   GLuint i;
+
+   for (i = 0; i < count; i++, STRIDE_F(from, stride)) {
+      const __m128 v = _mm_loadu_ps(from);
+      const __m128 w = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+      const GLubyte mask = clip_mask_sse(v, w, zmask);
+
+      clipMask[i] = mask;
+      if (mask) {
+         c++;
+         tmpAndMask &= mask;
+         tmpOrMask |= mask;
+         vProj[i][0] = 0;
+         vProj[i][1] = 0;
+         vProj[i][2] = 0;
+         vProj[i][3] = 1;
+      } else {
+         const __m128 oow = _mm_div_ps(_mm_set1_ps(1.0F), w);
+         _mm_storeu_ps(vProj[i], _mm_mul_ps(v, oow));
+         vProj[i][3] = _mm_cvtss_f32(oow);
+      }
+   }
+
+   *orMask = tmpOrMask;
+   *andMask = (GLubyte) (c < count ? 0 : tmpAndMask);
+
+   proj_vec->flags |= VEC_SIZE_4;
+   proj_vec->size = 4;
+   proj_vec->count = clip_vec->count;
+   return proj_vec;
+}
+
+
+static GLvector4f * _XFORMAPI
+sse_cliptest_np_points4(GLvector4f *clip_vec,
+                        GLvector4f *proj_vec,
+                        GLubyte clipMask[],
+                        GLubyte *orMask,
+                        GLubyte *andMask,
+                        GLboolean viewport_z_clip)
+{
+   const GLuint stride = clip_vec->stride;
+   const GLuint count = clip_vec->count;
+   const GLfloat *from = (GLfloat *)clip_vec->start;
+   const GLubyte zmask = viewport_z_clip ?
+      CLIP_FRUSTUM_BITS : CLIP_FRUSTUM_BITS & ~(CLIP_NEAR_BIT | CLIP_FAR_BIT);
+   GLuint c = 0;
+   GLubyte tmpAndMask = *andMask;
+   GLubyte tmpOrMask = *orMask;
+   GLuint i;
+   (void) proj_vec;
+
+   for (i = 0; i < count; i++, STRIDE_F(from, stride)) {
+      const __m128 v = _mm_loadu_ps(from);
+      const __m128 w = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+      const GLubyte mask = clip_mask_sse(v, w, zmask);
+
+      clipMask[i] = mask;
+      if (mask) {
+         c++;
+         tmpAndMask &= mask;
+         tmpOrMask |= mask;
+      }
+   }
+
+   *orMask = tmpOrMask;
+   *andMask = (GLubyte) (c < count ? 0 : tmpAndMask);
+   return clip_vec;
+}
+
+
+void
+_math_init_sse_cliptest(void)
+{
+   _mesa_clip_tab[4] = sse_cliptest_points4;
+   _mesa_clip_np_tab[4] = sse_cliptest_np_points4;
+}
+
+#endif /* __SSE2__ */
@@ -106,6 +106,10 @@ _math_init_transformation( void )
    init_copy0();
    init_dotprod();
 
+#ifdef __SSE2__
+   _math_init_sse_cliptest();
+#endif
+
 #ifdef DEBUG_MATH
    _math_test_all_transform_functions( "default" );
    _math_test_all_normal_transform_functions( "default" );
@@ -45,6 +45,8 @@ extern void
 _math_init_transformation(void);
 extern void
 init_c_cliptest(void);
+extern void
+_math_init_sse_cliptest(void);
 
 /* KW: Clip functions now do projective divide as well.  The projected
  * coordinates are very useful to us because they let us cull
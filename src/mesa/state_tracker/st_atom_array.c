@@ -365,7 +365,8 @@ is_interleaved_arrays(const struct st_vertex_program *vp,
  * \param velements  returns vertex element info
  */
 static boolean
-setup_interleaved_attribs(const struct st_vertex_program *vp,
+setup_interleaved_attribs(struct st_context *st,
+                          const struct st_vertex_program *vp,
                           const struct st_vp_variant *vpv,
                           const struct gl_client_array **arrays,
                           struct pipe_vertex_buffer *vbuffer,
@@ -445,6 +446,7 @@ setup_interleaved_attribs(const struct st_vertex_program *vp,
          return FALSE; /* out-of-memory error probably */
       }
 
+      st_finish_pbo_readback(st, stobj);
       vbuffer->buffer = stobj->buffer;
       vbuffer->user_buffer = NULL;
       vbuffer->buffer_offset = pointer_to_offset(low_addr);
@@ -497,6 +499,7 @@ setup_non_interleaved_attribs(struct st_context *st,
             return FALSE; /* out-of-memory error probably */
          }
 
+         st_finish_pbo_readback(st, stobj);
          vbuffer[attr].buffer = stobj->buffer;
          vbuffer[attr].user_buffer = NULL;
          vbuffer[attr].buffer_offset = pointer_to_offset(array->Ptr);
@@ -537,6 +540,32 @@ setup_non_interleaved_attribs(struct st_context *st,
    return TRUE;
 }
 
+/**
+ * Are the given vertex buffers the ones update_array() bound last time?
+ * The bound resources are referenced by the driver, so comparing the
+ * pointers is enough.  User buffers are always rebound since their
+ * contents may have changed behind the same pointer.
+ */
+static boolean
+vertex_buffers_equal(const struct st_context *st,
+                     const struct pipe_vertex_buffer *vbuffer,
+                     unsigned num_vbuffers)
+{
+   unsigned i;
+
+   if (num_vbuffers != st->last_num_vbuffers)
+      return FALSE;
+
+   for (i = 0; i < num_vbuffers; i++) {
+      if (vbuffer[i].user_buffer ||
+          memcmp(&vbuffer[i], &st->last_vbuffers[i], sizeof(vbuffer[i])))
+         return FALSE;
+   }
+
+   return TRUE;
+}
+
+
 static void update_array(struct st_context *st)
 {
    struct gl_context *ctx = st->ctx;
@@ -563,7 +592,8 @@ static void update_array(struct st_context *st)
     * Setup the vbuffer[] and velements[] arrays.
     */
    if (is_interleaved_arrays(vp, vpv, arrays)) {
-      if (!setup_interleaved_attribs(vp, vpv, arrays, vbuffer, velements)) {
+      if (!setup_interleaved_attribs(st, vp, vpv, arrays, vbuffer,
+                                     velements)) {
          st->vertex_array_out_of_memory = TRUE;
          return;
       }
@@ -584,14 +614,25 @@ static void update_array(struct st_context *st)
       num_velements = vpv->num_inputs;
    }
 
-   cso_set_vertex_buffers(st->cso_context, 0, num_vbuffers, vbuffer);
-   if (st->last_num_vbuffers > num_vbuffers) {
-      /* Unbind remaining buffers, if any. */
-      cso_set_vertex_buffers(st->cso_context, num_vbuffers,
-                             st->last_num_vbuffers - num_vbuffers, NULL);
+   if (!vertex_buffers_equal(st, vbuffer, num_vbuffers)) {
+      cso_set_vertex_buffers(st->cso_context, 0, num_vbuffers, vbuffer);
+      if (st->last_num_vbuffers > num_vbuffers) {
+         /* Unbind remaining buffers, if any. */
+         cso_set_vertex_buffers(st->cso_context, num_vbuffers,
+                                st->last_num_vbuffers - num_vbuffers, NULL);
+      }
+      st->last_num_vbuffers = num_vbuffers;
+      memcpy(st->last_vbuffers, vbuffer, num_vbuffers * sizeof(vbuffer[0]));
+   }
+
+   if (num_velements != st->last_num_velements ||
+       memcmp(velements, st->last_velements,
+              num_velements * sizeof(velements[0])) != 0) {
+      cso_set_vertex_elements(st->cso_context, num_velements, velements);
+      st->last_num_velements = num_velements;
+      memcpy(st->last_velements, velements,
+             num_velements * sizeof(velements[0]));
    }
-   st->last_num_vbuffers = num_vbuffers;
-   cso_set_vertex_elements(st->cso_context, num_velements, velements);
 }
 
 
@@ -127,8 +127,8 @@ static void update_vs_constants(struct st_context *st )
 const struct st_tracked_state st_update_vs_constants = {
    "st_update_vs_constants",				/* name */
    {							/* dirty */
-      _NEW_PROGRAM_CONSTANTS,                           /* mesa */
-      ST_NEW_VERTEX_PROGRAM,				/* st */
+      0,                                                /* mesa */
+      ST_NEW_VERTEX_PROGRAM | ST_NEW_VS_CONSTANTS,	/* st */
    },
    update_vs_constants					/* update */
 };
@@ -150,8 +150,8 @@ static void update_fs_constants(struct st_context *st )
 const struct st_tracked_state st_update_fs_constants = {
    "st_update_fs_constants",				/* name */
    {							/* dirty */
-      _NEW_PROGRAM_CONSTANTS,                           /* mesa */
-      ST_NEW_FRAGMENT_PROGRAM,				/* st */
+      0,                                                /* mesa */
+      ST_NEW_FRAGMENT_PROGRAM | ST_NEW_FS_CONSTANTS,	/* st */
    },
    update_fs_constants					/* update */
 };
@@ -172,8 +172,8 @@ static void update_gs_constants(struct st_context *st )
 const struct st_tracked_state st_update_gs_constants = {
    "st_update_gs_constants",				/* name */
    {							/* dirty */
-      _NEW_PROGRAM_CONSTANTS,                           /* mesa */
-      ST_NEW_GEOMETRY_PROGRAM,				/* st */
+      0,                                                /* mesa */
+      ST_NEW_GEOMETRY_PROGRAM | ST_NEW_GS_CONSTANTS,	/* st */
    },
    update_gs_constants					/* update */
 };
@@ -195,6 +195,7 @@ static void st_bind_ubos(struct st_context *st,
       binding = &st->ctx->UniformBufferBindings[shader->UniformBlocks[i].Binding];
       st_obj = st_buffer_object(binding->BufferObject);
 
+      st_finish_pbo_readback(st, st_obj);
       cb.buffer = st_obj->buffer;
 
       if (cb.buffer) {
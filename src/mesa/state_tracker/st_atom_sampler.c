@@ -234,6 +234,9 @@ convert_sampler(struct st_context *st,
 /**
  * Update the gallium driver's sampler state for fragment, vertex or
  * geometry shader stage.
+ *
+ * Only the slots whose state actually changed are passed to the CSO
+ * context, which saves hashing and looking up the unchanged ones.
  */
 static void
 update_shader_samplers(struct st_context *st,
@@ -241,7 +244,8 @@ update_shader_samplers(struct st_context *st,
                        const struct gl_program *prog,
                        unsigned max_units,
                        struct pipe_sampler_state *samplers,
-                       unsigned *num_samplers)
+                       unsigned *num_samplers,
+                       GLbitfield *bound_samplers)
 {
    GLuint unit;
    GLbitfield samplers_used;
@@ -260,15 +264,25 @@ update_shader_samplers(struct st_context *st,
 
       if (samplers_used & 1) {
          const GLuint texUnit = prog->SamplerUnits[unit];
+         struct pipe_sampler_state new_sampler;
 
-         convert_sampler(st, sampler, texUnit);
+         convert_sampler(st, &new_sampler, texUnit);
 
          *num_samplers = unit + 1;
 
-         cso_single_sampler(st->cso_context, shader_stage, unit, sampler);
+         if (!(*bound_samplers & (1 << unit)) ||
+             memcmp(sampler, &new_sampler, sizeof(new_sampler)) != 0) {
+            memcpy(sampler, &new_sampler, sizeof(new_sampler));
+            if (cso_single_sampler(st->cso_context, shader_stage, unit,
+                                   sampler) == PIPE_OK)
+               *bound_samplers |= 1 << unit;
+            else
+               *bound_samplers &= ~(1 << unit);
+         }
       }
       else if (samplers_used != 0 || unit < old_max) {
          cso_single_sampler(st->cso_context, shader_stage, unit, NULL);
+         *bound_samplers &= ~(1 << unit);
       }
       else {
          /* if we've reset all the old samplers and we have no more new ones */
@@ -290,14 +304,16 @@ update_samplers(struct st_context *st)
                           &ctx->FragmentProgram._Current->Base,
                           ctx->Const.Program[MESA_SHADER_FRAGMENT].MaxTextureImageUnits,
                           st->state.samplers[PIPE_SHADER_FRAGMENT],
-                          &st->state.num_samplers[PIPE_SHADER_FRAGMENT]);
+                          &st->state.num_samplers[PIPE_SHADER_FRAGMENT],
+                          &st->state.bound_samplers[PIPE_SHADER_FRAGMENT]);
 
    update_shader_samplers(st,
                           PIPE_SHADER_VERTEX,
                           &ctx->VertexProgram._Current->Base,
                           ctx->Const.Program[MESA_SHADER_VERTEX].MaxTextureImageUnits,
                           st->state.samplers[PIPE_SHADER_VERTEX],
-                          &st->state.num_samplers[PIPE_SHADER_VERTEX]);
+                          &st->state.num_samplers[PIPE_SHADER_VERTEX],
+                          &st->state.bound_samplers[PIPE_SHADER_VERTEX]);
 
    if (ctx->GeometryProgram._Current) {
       update_shader_samplers(st,
@@ -305,7 +321,8 @@ update_samplers(struct st_context *st)
                              &ctx->GeometryProgram._Current->Base,
                              ctx->Const.Program[MESA_SHADER_GEOMETRY].MaxTextureImageUnits,
                              st->state.samplers[PIPE_SHADER_GEOMETRY],
-                             &st->state.num_samplers[PIPE_SHADER_GEOMETRY]);
+                             &st->state.num_samplers[PIPE_SHADER_GEOMETRY],
+                             &st->state.bound_samplers[PIPE_SHADER_GEOMETRY]);
    }
 }
 
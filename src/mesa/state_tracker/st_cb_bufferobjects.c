@@ -40,6 +40,7 @@
 
 #include "st_context.h"
 #include "st_cb_bufferobjects.h"
+#include "st_cb_readpixels.h"
 #include "st_debug.h"
 
 #include "pipe/p_context.h"
@@ -79,6 +80,7 @@ st_bufferobj_free(struct gl_context *ctx, struct gl_buffer_object *obj)
 
    assert(obj->RefCount == 0);
    _mesa_buffer_unmap_all_mappings(ctx, obj);
+   st_discard_pbo_readback(st_context(ctx), st_obj);
 
    if (st_obj->buffer)
       pipe_resource_reference(&st_obj->buffer, NULL);
@@ -124,6 +126,8 @@ st_bufferobj_subdata(struct gl_context *ctx,
       return;
    }
 
+   st_finish_pbo_readback(st_context(ctx), st_obj);
+
    /* Now that transfers are per-context, we don't have to figure out
     * flushing here.  Usually drivers won't need to flush in this case
     * even if the buffer is currently referenced by hardware - they
@@ -160,6 +164,8 @@ st_bufferobj_get_subdata(struct gl_context *ctx,
       return;
    }
 
+   st_finish_pbo_readback(st_context(ctx), st_obj);
+
    pipe_buffer_read(st_context(ctx)->pipe, st_obj->buffer,
                     offset, size, data);
 }
@@ -186,6 +192,9 @@ st_bufferobj_data(struct gl_context *ctx,
    struct st_buffer_object *st_obj = st_buffer_object(obj);
    unsigned bind, pipe_usage, pipe_flags = 0;
 
+   /* The old contents are gone, so is a pending glReadPixels into them. */
+   st_discard_pbo_readback(st, st_obj);
+
    if (size && data && st_obj->buffer &&
        st_obj->Base.Size == size &&
        st_obj->Base.Usage == usage &&
@@ -323,6 +332,8 @@ st_bufferobj_map_range(struct gl_context *ctx,
    struct st_buffer_object *st_obj = st_buffer_object(obj);
    enum pipe_transfer_usage flags = 0x0;
 
+   st_finish_pbo_readback(st_context(ctx), st_obj);
+
    if (access & GL_MAP_WRITE_BIT)
       flags |= PIPE_TRANSFER_WRITE;
 
@@ -447,6 +458,9 @@ st_copy_buffer_subdata(struct gl_context *ctx,
    assert(!_mesa_check_disallowed_mapping(src));
    assert(!_mesa_check_disallowed_mapping(dst));
 
+   st_finish_pbo_readback(st_context(ctx), srcObj);
+   st_finish_pbo_readback(st_context(ctx), dstObj);
+
    u_box_1d(readOffset, size, &box);
 
    pipe->resource_copy_region(pipe, dstObj->buffer, 0, writeOffset, 0, 0,
@@ -467,6 +481,8 @@ st_clear_buffer_subdata(struct gl_context *ctx,
    struct st_buffer_object *buf = st_buffer_object(bufObj);
    static const char zeros[16] = {0};
 
+   st_finish_pbo_readback(st_context(ctx), buf);
+
    if (!pipe->clear_buffer) {
       _mesa_buffer_clear_subdata(ctx, offset, size,
                                  clearValue, clearValueSize, bufObj);
@@ -34,6 +34,7 @@
 struct dd_function_table;
 struct pipe_resource;
 struct st_context;
+struct st_pbo_readback;
 
 /**
  * State_tracker vertex/pixel buffer object, derived from Mesa's
@@ -44,6 +45,9 @@ struct st_buffer_object
    struct gl_buffer_object Base;
    struct pipe_resource *buffer;     /* GPU storage */
    struct pipe_transfer *transfer[MAP_COUNT];
+
+   /** glReadPixels into this buffer not written yet, see st_cb_readpixels.c */
+   struct st_pbo_readback *readback;
 };
 
 
@@ -55,6 +59,22 @@ st_buffer_object(struct gl_buffer_object *obj)
 }
 
 
+/**
+ * Make sure the results of a pending glReadPixels have landed in the
+ * buffer.  Must be called before accessing the buffer's contents.
+ */
+extern void
+st_finish_pbo_readback_slow(struct st_context *st,
+                            struct st_buffer_object *obj);
+
+static INLINE void
+st_finish_pbo_readback(struct st_context *st, struct st_buffer_object *obj)
+{
+   if (obj->readback)
+      st_finish_pbo_readback_slow(st, obj);
+}
+
+
 extern void
 st_bufferobj_validate_usage(struct st_context *st,
 			    struct st_buffer_object *obj,
@@ -1163,6 +1163,8 @@ st_DrawPixels(struct gl_context *ctx, GLint x, GLint y,
 
    /* update fragment program constants */
    st_upload_constants(st, fpv->parameters, PIPE_SHADER_FRAGMENT);
+   /* the user's constants must be uploaded again for the next draw */
+   st->dirty.st |= ST_NEW_FS_CONSTANTS;
 
    /* draw with textured quad */
    {
@@ -1536,6 +1538,8 @@ st_CopyPixels(struct gl_context *ctx, GLint srcx, GLint srcy,
 
    /* update fragment program constants */
    st_upload_constants(st, fpv->parameters, PIPE_SHADER_FRAGMENT);
+   /* the user's constants must be uploaded again for the next draw */
+   st->dirty.st |= ST_NEW_FS_CONSTANTS;
 
    /* Choose the format for the temporary texture. */
    srcFormat = rbRead->texture->format;
@@ -31,6 +31,7 @@
 #include "main/readpix.h"
 #include "main/enums.h"
 #include "main/framebuffer.h"
+#include "main/bufferobj.h"
 #include "util/u_inlines.h"
 #include "util/u_format.h"
 
@@ -39,53 +40,56 @@
 #include "st_context.h"
 #include "st_cb_bitmap.h"
 #include "st_cb_readpixels.h"
+#include "state_tracker/st_cb_bufferobjects.h"
 #include "state_tracker/st_cb_texture.h"
 #include "state_tracker/st_format.h"
 #include "state_tracker/st_texture.h"
 
 
 /**
- * This uses a blit to copy the read buffer to a texture format which matches
- * the format and type combo and then a fast read-back is done using memcpy.
- * We can do arbitrary X/Y/Z/W/0/1 swizzling here as long as there is
- * a format which matches the swizzling.
- *
- * If such a format isn't available, we fall back to _mesa_readpixels.
+ * A glReadPixels into a pixel pack buffer which has been blitted into a
+ * staging texture but not copied into the buffer yet.
+ */
+struct st_pbo_readback
+{
+   struct st_context *st;
+   struct gl_buffer_object *obj;       /**< the PBO */
+   struct pipe_resource *staging;      /**< blit destination */
+   struct pipe_fence_handle *fence;    /**< signalled when the blit is done */
+   GLintptr offset;                    /**< PBO offset of the first row */
+   GLintptr stride;                    /**< PBO row stride in bytes */
+   unsigned bytes_per_row;
+   unsigned height;
+   struct st_pbo_readback *next;
+};
+
+/** Max number of readbacks in flight per context */
+#define MAX_PBO_READBACKS 16
+
+
+/**
+ * Blit the given region of the read buffer into a new staging texture
+ * whose format matches the format and type combo, so that it can be read
+ * back with memcpy.  We can do arbitrary X/Y/Z/W/0/1 swizzling here as
+ * long as there is a format which matches the swizzling.
  *
- * NOTE: Some drivers use a blit to convert between tiled and linear
- *       texture layouts during texture uploads/downloads, so the blit
- *       we do here should be free in such cases.
+ * \return the staging texture or NULL if the blit can't be done.
  */
-static void
-st_readpixels(struct gl_context *ctx, GLint x, GLint y,
-              GLsizei width, GLsizei height,
-              GLenum format, GLenum type,
-              const struct gl_pixelstore_attrib *pack,
-              GLvoid *pixels)
+static struct pipe_resource *
+blit_to_staging(struct st_context *st, struct gl_renderbuffer *rb,
+                GLint x, GLint y, GLsizei width, GLsizei height,
+                GLenum format, GLenum type,
+                const struct gl_pixelstore_attrib *pack)
 {
-   struct st_context *st = st_context(ctx);
-   struct gl_renderbuffer *rb =
-         _mesa_get_read_renderbuffer_for_format(ctx, format);
+   struct gl_context *ctx = st->ctx;
    struct st_renderbuffer *strb = st_renderbuffer(rb);
-   struct pipe_context *pipe = st->pipe;
-   struct pipe_screen *screen = pipe->screen;
+   struct pipe_screen *screen = st->pipe->screen;
    struct pipe_resource *src;
-   struct pipe_resource *dst = NULL;
+   struct pipe_resource *dst;
    struct pipe_resource dst_templ;
    enum pipe_format dst_format, src_format;
    struct pipe_blit_info blit;
    unsigned bind = PIPE_BIND_TRANSFER_READ;
-   struct pipe_transfer *tex_xfer;
-   ubyte *map = NULL;
-
-   /* Validate state (to be sure we have up-to-date framebuffer surfaces)
-    * and flush the bitmap cache prior to reading. */
-   st_validate_state(st);
-   st_flush_bitmap_cache(st);
-
-   if (!st->prefer_blit_based_texture_transfer) {
-      goto fallback;
-   }
 
    /* This must be done after state validation. */
    src = strb->texture;
@@ -93,7 +97,7 @@ st_readpixels(struct gl_context *ctx, GLint x, GLint y,
    /* XXX Fallback for depth-stencil formats due to an incomplete
     * stencil blit implementation in some drivers. */
    if (format == GL_DEPTH_STENCIL) {
-      goto fallback;
+      return NULL;
    }
 
    /* We are creating a texture of the size of the region being read back.
@@ -101,26 +105,18 @@ st_readpixels(struct gl_context *ctx, GLint x, GLint y,
    if (!screen->get_param(screen, PIPE_CAP_NPOT_TEXTURES) &&
        (!util_is_power_of_two(width) ||
         !util_is_power_of_two(height))) {
-      goto fallback;
+      return NULL;
    }
 
    /* If the base internal format and the texture format don't match, we have
     * to use the slow path. */
    if (rb->_BaseFormat !=
        _mesa_get_format_base_format(rb->Format)) {
-      goto fallback;
-   }
-
-   /* See if the texture format already matches the format and type,
-    * in which case the memcpy-based fast path will likely be used and
-    * we don't have to blit. */
-   if (_mesa_format_matches_format_and_type(rb->Format, format,
-                                            type, pack->SwapBytes)) {
-      goto fallback;
+      return NULL;
    }
 
    if (_mesa_readpixels_needs_slow_path(ctx, format, type, GL_TRUE)) {
-      goto fallback;
+      return NULL;
    }
 
    /* Convert the source format to what is expected by ReadPixels
@@ -133,7 +129,7 @@ st_readpixels(struct gl_context *ctx, GLint x, GLint y,
        !screen->is_format_supported(screen, src_format, src->target,
                                     src->nr_samples,
                                     PIPE_BIND_SAMPLER_VIEW)) {
-      goto fallback;
+      return NULL;
    }
 
    if (format == GL_DEPTH_COMPONENT || format == GL_DEPTH_STENCIL)
@@ -146,7 +142,7 @@ st_readpixels(struct gl_context *ctx, GLint x, GLint y,
    dst_format = st_choose_matching_format(st, bind, format, type,
                                           pack->SwapBytes);
    if (dst_format == PIPE_FORMAT_NONE) {
-      goto fallback;
+      return NULL;
    }
 
    /* create the destination texture */
@@ -162,7 +158,7 @@ st_readpixels(struct gl_context *ctx, GLint x, GLint y,
 
    dst = screen->resource_create(screen, &dst_templ);
    if (!dst) {
-      goto fallback;
+      return NULL;
    }
 
    memset(&blit, 0, sizeof(blit));
@@ -194,6 +190,254 @@ st_readpixels(struct gl_context *ctx, GLint x, GLint y,
    /* blit */
    st->pipe->blit(st->pipe, &blit);
 
+   return dst;
+}
+
+
+/**
+ * Remove a readback from the context's list and free it.
+ */
+static void
+release_pbo_readback(struct st_pbo_readback *rb)
+{
+   struct st_context *st = rb->st;
+   struct st_pbo_readback **prev = &st->pbo_readbacks;
+
+   while (*prev != rb)
+      prev = &(*prev)->next;
+   *prev = rb->next;
+   st->num_pbo_readbacks--;
+
+   st_buffer_object(rb->obj)->readback = NULL;
+   st->pipe->screen->fence_reference(st->pipe->screen, &rb->fence, NULL);
+   pipe_resource_reference(&rb->staging, NULL);
+   free(rb);
+}
+
+
+/**
+ * Wait for a queued readback and copy its pixels into the PBO.
+ * Called via st_finish_pbo_readback() before the buffer contents are
+ * accessed in any way.
+ *
+ * Only the context which queued the readback may finish it, since that
+ * uses its pipe context.  Readbacks are never pending while the buffers
+ * are shared with another context, see st_finish_pbo_readbacks().
+ */
+void
+st_finish_pbo_readback_slow(struct st_context *st,
+                            struct st_buffer_object *stobj)
+{
+   struct st_pbo_readback *rb = stobj->readback;
+   struct pipe_context *pipe = st->pipe;
+   struct pipe_screen *screen = pipe->screen;
+   struct pipe_transfer *tex_xfer, *buf_xfer;
+   const ubyte *map;
+   ubyte *dest;
+   unsigned row;
+
+   if (rb->st != st)
+      return;
+
+   if (rb->fence)
+      screen->fence_finish(screen, rb->fence, PIPE_TIMEOUT_INFINITE);
+
+   map = pipe_transfer_map(pipe, rb->staging, 0, 0, PIPE_TRANSFER_READ,
+                           0, 0, rb->staging->width0, rb->height,
+                           &tex_xfer);
+   dest = pipe_buffer_map_range(pipe, stobj->buffer, rb->offset,
+                                (rb->height - 1) * rb->stride +
+                                rb->bytes_per_row,
+                                PIPE_TRANSFER_WRITE, &buf_xfer);
+
+   if (map && dest) {
+      for (row = 0; row < rb->height; row++) {
+         memcpy(dest, map, rb->bytes_per_row);
+         dest += rb->stride;
+         map += tex_xfer->stride;
+      }
+   }
+   else {
+      _mesa_error(st->ctx, GL_OUT_OF_MEMORY, "glReadPixels");
+   }
+
+   if (dest)
+      pipe_buffer_unmap(pipe, buf_xfer);
+   if (map)
+      pipe_transfer_unmap(pipe, tex_xfer);
+
+   stobj->Base.MinMaxCacheDirty = true;
+
+   release_pbo_readback(rb);
+}
+
+
+/**
+ * Drop a queued readback whose results are no longer needed because the
+ * buffer's contents are being replaced or the buffer is deleted.
+ */
+void
+st_discard_pbo_readback(struct st_context *st,
+                        struct st_buffer_object *stobj)
+{
+   if (stobj->readback && stobj->readback->st == st)
+      release_pbo_readback(stobj->readback);
+}
+
+
+/**
+ * Finish all queued readbacks of the context.  Readbacks are only queued
+ * while no other context shares the buffers, so this is called before
+ * another context joins the share group, as well as on destruction.
+ */
+void
+st_finish_pbo_readbacks(struct st_context *st)
+{
+   while (st->pbo_readbacks)
+      st_finish_pbo_readback_slow(st,
+                                  st_buffer_object(st->pbo_readbacks->obj));
+}
+
+
+/**
+ * Try to do a glReadPixels into a pixel pack buffer asynchronously: the
+ * pixels are blitted into a staging texture now, and only copied into
+ * the buffer once it is actually accessed.  This lets the application
+ * keep rendering while the driver processes the blit.
+ */
+static boolean
+try_pbo_readback(struct st_context *st, struct gl_renderbuffer *rb,
+                 GLint x, GLint y, GLsizei width, GLsizei height,
+                 GLenum format, GLenum type,
+                 const struct gl_pixelstore_attrib *pack,
+                 GLvoid *pixels)
+{
+   struct pipe_context *pipe = st->pipe;
+   struct gl_buffer_object *obj = pack->BufferObj;
+   struct st_buffer_object *stobj = st_buffer_object(obj);
+   struct st_pbo_readback *readback;
+   struct pipe_resource *dst;
+   GLubyte *row0, *row1;
+
+   /* Only one readback per buffer is in flight at any time. */
+   st_finish_pbo_readback(st, stobj);
+
+   /* A mapped buffer has to be written right away.  So do buffers which
+    * another context may access, since only this context can finish the
+    * readback.  Inverted rows are left to the synchronous path as well.
+    */
+   if (!stobj->buffer ||
+       _mesa_bufferobj_mapped(obj, MAP_USER) ||
+       st->ctx->Shared->RefCount > 1 ||
+       pack->Invert)
+      return FALSE;
+
+   if (st->num_pbo_readbacks >= MAX_PBO_READBACKS) {
+      struct st_pbo_readback *oldest = st->pbo_readbacks;
+
+      while (oldest->next)
+         oldest = oldest->next;
+      st_finish_pbo_readback_slow(st, st_buffer_object(oldest->obj));
+   }
+
+   readback = CALLOC_STRUCT(st_pbo_readback);
+   if (!readback)
+      return FALSE;
+
+   dst = blit_to_staging(st, rb, x, y, width, height, format, type, pack);
+   if (!dst) {
+      free(readback);
+      return FALSE;
+   }
+
+   /* Make the driver start working on the blit. */
+   pipe->flush(pipe, &readback->fence, 0);
+
+   row0 = (GLubyte *) _mesa_image_address2d(pack, pixels, width, height,
+                                            format, type, 0, 0);
+   row1 = (GLubyte *) _mesa_image_address2d(pack, pixels, width, height,
+                                            format, type, 1, 0);
+
+   readback->st = st;
+   readback->obj = obj;
+   readback->staging = dst;
+   readback->offset = (GLintptr) row0;
+   readback->stride = row1 - row0;
+   readback->bytes_per_row = width * util_format_get_blocksize(dst->format);
+   readback->height = height;
+
+   readback->next = st->pbo_readbacks;
+   st->pbo_readbacks = readback;
+   st->num_pbo_readbacks++;
+   stobj->readback = readback;
+
+   /* The buffer may already be bound as a vertex, uniform or texture
+    * buffer.  Make the atoms which bind those look at it again, they
+    * finish the readback before the GPU reads the buffer.
+    */
+   st->dirty.st |= ST_NEW_VERTEX_ARRAYS | ST_NEW_UNIFORM_BUFFER;
+   st->dirty.mesa |= _NEW_TEXTURE;
+
+   return TRUE;
+}
+
+
+/**
+ * This uses a blit to copy the read buffer to a texture format which matches
+ * the format and type combo and then a fast read-back is done using memcpy.
+ *
+ * If such a format isn't available, we fall back to _mesa_readpixels.
+ *
+ * Reads into a pixel pack buffer are done asynchronously if possible, see
+ * try_pbo_readback().
+ *
+ * NOTE: Some drivers use a blit to convert between tiled and linear
+ *       texture layouts during texture uploads/downloads, so the blit
+ *       we do here should be free in such cases.
+ */
+static void
+st_readpixels(struct gl_context *ctx, GLint x, GLint y,
+              GLsizei width, GLsizei height,
+              GLenum format, GLenum type,
+              const struct gl_pixelstore_attrib *pack,
+              GLvoid *pixels)
+{
+   struct st_context *st = st_context(ctx);
+   struct gl_renderbuffer *rb =
+         _mesa_get_read_renderbuffer_for_format(ctx, format);
+   struct pipe_context *pipe = st->pipe;
+   struct pipe_resource *dst;
+   struct pipe_transfer *tex_xfer;
+   ubyte *map = NULL;
+
+   /* Validate state (to be sure we have up-to-date framebuffer surfaces)
+    * and flush the bitmap cache prior to reading. */
+   st_validate_state(st);
+   st_flush_bitmap_cache(st);
+
+   if (_mesa_is_bufferobj(pack->BufferObj) &&
+       try_pbo_readback(st, rb, x, y, width, height, format, type,
+                        pack, pixels)) {
+      return;
+   }
+
+   if (!st->prefer_blit_based_texture_transfer) {
+      goto fallback;
+   }
+
+   /* See if the texture format already matches the format and type,
+    * in which case the memcpy-based fast path will likely be used and
+    * we don't have to blit. */
+   if (_mesa_format_matches_format_and_type(rb->Format, format,
+                                            type, pack->SwapBytes)) {
+      goto fallback;
+   }
+
+   dst = blit_to_staging(st, rb, x, y, width, height, format, type, pack);
+   if (!dst) {
+      goto fallback;
+   }
+
    /* map resources */
    pixels = _mesa_map_pbo_dest(ctx, pack, pixels);
 
@@ -207,7 +451,7 @@ st_readpixels(struct gl_context *ctx, GLint x, GLint y,
 
    /* memcpy data into a user buffer */
    {
-      const uint bytesPerRow = width * util_format_get_blocksize(dst_format);
+      const uint bytesPerRow = width * util_format_get_blocksize(dst->format);
       GLuint row;
 
       for (row = 0; row < (unsigned) height; row++) {
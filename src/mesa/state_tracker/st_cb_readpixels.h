@@ -32,9 +32,18 @@
 #include "main/glheader.h"
 
 struct dd_function_table;
+struct st_context;
+struct st_buffer_object;
 
 extern void
 st_init_readpixels_functions(struct dd_function_table *functions);
 
+extern void
+st_discard_pbo_readback(struct st_context *st,
+                        struct st_buffer_object *stobj);
+
+extern void
+st_finish_pbo_readbacks(struct st_context *st);
+
 
 #endif /* ST_CB_READPIXELS_H */
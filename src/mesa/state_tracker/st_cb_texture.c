@@ -1571,6 +1571,8 @@ st_finalize_texture(struct gl_context *ctx,
          return GL_TRUE;
       }
 
+      st_finish_pbo_readback(st, st_obj);
+
       if (st_obj->buffer != stObj->pt) {
          pipe_resource_reference(&stObj->pt, st_obj->buffer);
          st_texture_release_all_sampler_views(stObj);
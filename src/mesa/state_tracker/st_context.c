@@ -128,6 +128,9 @@ st_create_context_priv( struct gl_context *ctx, struct pipe_context *pipe,
    st->dirty.mesa = ~0;
    st->dirty.st = ~0;
 
+   /* nothing bound yet, see update_array() */
+   st->last_num_velements = ~0u;
+
    /* Create upload manager for vertex data for glBitmap, glDrawPixels,
     * glClear, etc.
     */
@@ -252,6 +255,9 @@ static void st_init_driver_flags(struct gl_driver_flags *f)
    f->NewArray = ST_NEW_VERTEX_ARRAYS;
    f->NewRasterizerDiscard = ST_NEW_RASTERIZER;
    f->NewUniformBuffer = ST_NEW_UNIFORM_BUFFER;
+   f->NewShaderConstants[MESA_SHADER_VERTEX] = ST_NEW_VS_CONSTANTS;
+   f->NewShaderConstants[MESA_SHADER_GEOMETRY] = ST_NEW_GS_CONSTANTS;
+   f->NewShaderConstants[MESA_SHADER_FRAGMENT] = ST_NEW_FS_CONSTANTS;
 }
 
 struct st_context *st_create_context(gl_api api, struct pipe_context *pipe,
@@ -266,6 +272,12 @@ struct st_context *st_create_context(gl_api api, struct pipe_context *pipe,
    memset(&funcs, 0, sizeof(funcs));
    st_init_driver_functions(&funcs);
 
+   /* Pending PBO readbacks can only be finished by the context which
+    * queued them, so finish them before the buffers become shared.
+    */
+   if (share)
+      st_finish_pbo_readbacks(share);
+
    ctx = _mesa_create_context(api, visual, shareCtx, &funcs);
    if (!ctx) {
       return NULL;
@@ -339,6 +351,8 @@ void st_destroy_context( struct st_context *st )
 
    _mesa_HashWalk(ctx->Shared->TexObjects, destroy_tex_sampler_cb, st);
 
+   st_finish_pbo_readbacks(st);
+
    /* need to unbind and destroy CSO objects before anything else */
    cso_release_all(st->cso_context);
 
@@ -40,6 +40,7 @@ struct draw_stage;
 struct gen_mipmap_state;
 struct st_context;
 struct st_fragment_program;
+struct st_pbo_readback;
 struct u_upload_mgr;
 
 
@@ -52,6 +53,9 @@ struct u_upload_mgr;
 #define ST_NEW_VERTEX_ARRAYS           (1 << 6)
 #define ST_NEW_RASTERIZER              (1 << 7)
 #define ST_NEW_UNIFORM_BUFFER          (1 << 8)
+#define ST_NEW_VS_CONSTANTS            (1 << 9)
+#define ST_NEW_FS_CONSTANTS            (1 << 10)
+#define ST_NEW_GS_CONSTANTS            (1 << 11)
 
 
 struct st_state_flags {
@@ -109,6 +113,8 @@ struct st_context
       struct pipe_rasterizer_state          rasterizer;
       struct pipe_sampler_state samplers[PIPE_SHADER_TYPES][PIPE_MAX_SAMPLERS];
       GLuint num_samplers[PIPE_SHADER_TYPES];
+      /** Slots of samplers[] which are currently bound in the CSO context */
+      GLbitfield bound_samplers[PIPE_SHADER_TYPES];
       struct pipe_sampler_view *sampler_views[PIPE_SHADER_TYPES][PIPE_MAX_SAMPLERS];
       GLuint num_sampler_views[PIPE_SHADER_TYPES];
       struct pipe_clip_state clip;
@@ -198,6 +204,18 @@ struct st_context
    /* The number of vertex buffers from the last call of validate_arrays. */
    unsigned last_num_vbuffers;
 
+   /* The vertex buffers and elements last bound by st_update_array, so
+    * that switching back and forth between the same arrays doesn't have
+    * to go through the cso hash or the driver again.
+    */
+   struct pipe_vertex_buffer last_vbuffers[PIPE_MAX_SHADER_INPUTS];
+   struct pipe_vertex_element last_velements[PIPE_MAX_ATTRIBS];
+   unsigned last_num_velements;
+
+   /** Queued glReadPixels into PBOs, see st_cb_readpixels.c */
+   struct st_pbo_readback *pbo_readbacks;
+   unsigned num_pbo_readbacks;
+
    int32_t draw_stamp;
    int32_t read_stamp;
 
@@ -100,6 +100,7 @@ setup_index_buffer(struct st_context *st,
    /* get/create the index buffer object */
    if (_mesa_is_bufferobj(bufobj)) {
       /* indices are in a real VBO */
+      st_finish_pbo_readback(st, st_buffer_object(bufobj));
       ibuffer->buffer = st_buffer_object(bufobj)->buffer;
       ibuffer->offset = pointer_to_offset(ib->ptr);
    }
@@ -245,6 +246,7 @@ st_draw_vbo(struct gl_context *ctx,
    }
 
    if (indirect) {
+      st_finish_pbo_readback(st, st_buffer_object(indirect));
       info.indirect = st_buffer_object(indirect)->buffer;
 
       /* Primitive restart is not handled by the VBO module in this case. */
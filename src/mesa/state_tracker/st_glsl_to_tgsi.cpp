@@ -445,7 +445,9 @@ public:
 
    void simplify_cmp(void);
 
-   void rename_temp_register(int index, int new_index);
+   void rename_temp_registers(const int *renames);
+   void get_temp_live_ranges(int *first_reads, int *first_writes,
+                             int *last_reads);
    int get_first_temp_read(int index);
    int get_first_temp_write(int index);
    int get_last_temp_read(int index);
@@ -3317,30 +3319,87 @@ glsl_to_tgsi_visitor::simplify_cmp(void)
    free(tempWrites);
 }
 
-/* Replaces all references to a temporary register index with another index. */
+/* Replaces all references to each temporary register index i with
+ * renames[i], in a single walk over the instructions. */
 void
-glsl_to_tgsi_visitor::rename_temp_register(int index, int new_index)
+glsl_to_tgsi_visitor::rename_temp_registers(const int *renames)
 {
    foreach_in_list(glsl_to_tgsi_instruction, inst, &this->instructions) {
       unsigned j;
-      
+
       for (j=0; j < num_inst_src_regs(inst->op); j++) {
-         if (inst->src[j].file == PROGRAM_TEMPORARY && 
-             inst->src[j].index == index) {
-            inst->src[j].index = new_index;
-         }
+         if (inst->src[j].file == PROGRAM_TEMPORARY)
+            inst->src[j].index = renames[inst->src[j].index];
       }
 
       for (j=0; j < inst->tex_offset_num_offset; j++) {
-         if (inst->tex_offsets[j].file == PROGRAM_TEMPORARY && 
-             inst->tex_offsets[j].index == index) {
-            inst->tex_offsets[j].index = new_index;
-         }
+         if (inst->tex_offsets[j].file == PROGRAM_TEMPORARY)
+            inst->tex_offsets[j].index = renames[inst->tex_offsets[j].index];
       }
-      
-      if (inst->dst.file == PROGRAM_TEMPORARY && inst->dst.index == index) {
-         inst->dst.index = new_index;
+
+      if (inst->dst.file == PROGRAM_TEMPORARY)
+         inst->dst.index = renames[inst->dst.index];
+   }
+}
+
+/* Computes get_first_temp_read(), get_first_temp_write() and
+ * get_last_temp_read() for every temporary register at once, with the same
+ * handling of loops: a temporary accessed inside a loop is considered live
+ * for the whole outermost loop. */
+void
+glsl_to_tgsi_visitor::get_temp_live_ranges(int *first_reads,
+                                           int *first_writes,
+                                           int *last_reads)
+{
+   int depth = 0; /* loop depth */
+   int loop_start = -1; /* index of the first active BGNLOOP (if any) */
+   int i = 0, j;
+
+   for (j=0; j < this->next_temp; j++) {
+      first_reads[j] = -1;
+      first_writes[j] = -1;
+      last_reads[j] = -1;
+   }
+
+   foreach_in_list(glsl_to_tgsi_instruction, inst, &this->instructions) {
+      const int pos = (depth == 0) ? i : loop_start;
+      unsigned k;
+
+      for (k=0; k < num_inst_src_regs(inst->op) + inst->tex_offset_num_offset;
+           k++) {
+         const st_src_reg *src = k < num_inst_src_regs(inst->op) ?
+            &inst->src[k] :
+            &inst->tex_offsets[k - num_inst_src_regs(inst->op)];
+
+         if (src->file != PROGRAM_TEMPORARY)
+            continue;
+
+         if (first_reads[src->index] < 0)
+            first_reads[src->index] = pos;
+         last_reads[src->index] = (depth == 0) ? i : -2;
+      }
+
+      if (inst->dst.file == PROGRAM_TEMPORARY &&
+          first_writes[inst->dst.index] < 0)
+         first_writes[inst->dst.index] = pos;
+
+      if (inst->op == TGSI_OPCODE_BGNLOOP) {
+         if (depth++ == 0)
+            loop_start = i;
+      } else if (inst->op == TGSI_OPCODE_ENDLOOP) {
+         if (--depth == 0) {
+            loop_start = -1;
+
+            /* Reads inside the loop extend to the end of the loop. */
+            for (j=0; j < this->next_temp; j++) {
+               if (last_reads[j] == -2)
+                  last_reads[j] = i;
+            }
+         }
       }
+      assert(depth >= 0);
+
+      i++;
    }
 }
 
@@ -3834,55 +3893,75 @@ glsl_to_tgsi_visitor::eliminate_dead_code(void)
 
 /* Merges temporary registers together where possible to reduce the number of 
  * registers needed to run a program.
+ *
+ * Each temporary is live from its first write to its last read.  Walking the
+ * temporaries in order of first write and giving each one the lowest
+ * register whose previous occupant is no longer live (linear scan) uses the
+ * smallest possible number of registers for those live ranges.
  * 
  * Produces optimal code only after copy propagation and dead code elimination 
  * have been run. */
 void
 glsl_to_tgsi_visitor::merge_registers(void)
 {
-   int *last_reads = rzalloc_array(mem_ctx, int, this->next_temp);
-   int *first_writes = rzalloc_array(mem_ctx, int, this->next_temp);
+   int *first_reads = ralloc_array(mem_ctx, int, this->next_temp);
+   int *first_writes = ralloc_array(mem_ctx, int, this->next_temp);
+   int *last_reads = ralloc_array(mem_ctx, int, this->next_temp);
+   int *order = ralloc_array(mem_ctx, int, this->next_temp);
+   int *renames = ralloc_array(mem_ctx, int, this->next_temp);
+   /* For each register handed out so far: the first temporary allocated to
+    * it, whose index the register keeps, and the temporary currently in it. */
+   int *reg_names = ralloc_array(mem_ctx, int, this->next_temp);
+   int *reg_temps = ralloc_array(mem_ctx, int, this->next_temp);
+   int num_order = 0, num_regs = 0;
    int i, j;
-   
-   /* Read the indices of the last read and first write to each temp register
-    * into an array so that we don't have to traverse the instruction list as 
-    * much. */
-   for (i=0; i < this->next_temp; i++) {
-      last_reads[i] = get_last_temp_read(i);
-      first_writes[i] = get_first_temp_write(i);
-   }
-   
-   /* Start looking for registers with non-overlapping usages that can be 
-    * merged together. */
+
+   get_temp_live_ranges(first_reads, first_writes, last_reads);
+
+   /* Sort the live temporaries by first write (insertion sort; the list is
+    * nearly sorted already since temporaries are allocated in program
+    * order). */
    for (i=0; i < this->next_temp; i++) {
+      renames[i] = i;
+
       /* Don't touch unused registers. */
       if (last_reads[i] < 0 || first_writes[i] < 0) continue;
-      
-      for (j=0; j < this->next_temp; j++) {
-         /* Don't touch unused registers. */
-         if (last_reads[j] < 0 || first_writes[j] < 0) continue;
-         
-         /* We can merge the two registers if the first write to j is after or 
-          * in the same instruction as the last read from i.  Note that the 
-          * register at index i will always be used earlier or at the same time 
-          * as the register at index j. */
-         if (first_writes[i] <= first_writes[j] && 
-             last_reads[i] <= first_writes[j])
-         {
-            rename_temp_register(j, i); /* Replace all references to j with i.*/
-            
-            /* Update the first_writes and last_reads arrays with the new 
-             * values for the merged register index, and mark the newly unused 
-             * register index as such. */
-            last_reads[i] = last_reads[j];
-            first_writes[j] = -1;
-            last_reads[j] = -1;
-         }
+
+      for (j = num_order;
+           j > 0 && first_writes[order[j - 1]] > first_writes[i]; j--)
+         order[j] = order[j - 1];
+      order[j] = i;
+      num_order++;
+   }
+
+   for (i=0; i < num_order; i++) {
+      const int temp = order[i];
+
+      /* We can reuse a register if the first write to temp is after or in
+       * the same instruction as the last read of its current occupant. */
+      for (j=0; j < num_regs; j++) {
+         if (last_reads[reg_temps[j]] <= first_writes[temp])
+            break;
       }
+
+      if (j == num_regs) {
+         reg_names[j] = temp;
+         num_regs++;
+      }
+
+      reg_temps[j] = temp;
+      renames[temp] = reg_names[j];
    }
-   
-   ralloc_free(last_reads);
+
+   rename_temp_registers(renames);
+
+   ralloc_free(first_reads);
    ralloc_free(first_writes);
+   ralloc_free(last_reads);
+   ralloc_free(order);
+   ralloc_free(renames);
+   ralloc_free(reg_names);
+   ralloc_free(reg_temps);
 }
 
 /* Reassign indices to temporary registers by reusing unused indices created 
@@ -3890,17 +3969,28 @@ glsl_to_tgsi_visitor::merge_registers(void)
 void
 glsl_to_tgsi_visitor::renumber_registers(void)
 {
+   int *first_reads = ralloc_array(mem_ctx, int, this->next_temp);
+   int *first_writes = ralloc_array(mem_ctx, int, this->next_temp);
+   int *last_reads = ralloc_array(mem_ctx, int, this->next_temp);
+   int *renames = ralloc_array(mem_ctx, int, this->next_temp);
    int i = 0;
    int new_index = 0;
-   
+
+   get_temp_live_ranges(first_reads, first_writes, last_reads);
+
    for (i=0; i < this->next_temp; i++) {
-      if (get_first_temp_read(i) < 0) continue;
-      if (i != new_index)
-         rename_temp_register(i, new_index);
-      new_index++;
+      renames[i] = i;
+      if (first_reads[i] < 0) continue;
+      renames[i] = new_index++;
    }
-   
+
+   rename_temp_registers(renames);
    this->next_temp = new_index;
+
+   ralloc_free(first_reads);
+   ralloc_free(first_writes);
+   ralloc_free(last_reads);
+   ralloc_free(renames);
 }
 
 /**
@@ -5268,6 +5358,7 @@ get_mesa_program(struct gl_context *ctx,
    v->copy_propagate();
    while (v->eliminate_dead_code());
 
+   const int num_ir_temps = v->next_temp;
    v->merge_registers();
    v->renumber_registers();
    
@@ -5281,6 +5372,8 @@ get_mesa_program(struct gl_context *ctx,
              shader_program->Name);
       _mesa_print_ir(stdout, shader->ir, NULL);
       printf("\n");
+      printf("%d temporary registers, %d before register merging\n",
+             v->next_temp, num_ir_temps);
       printf("\n");
       fflush(stdout);
    }
@@ -197,6 +197,8 @@ _swrast_update_texture_env( struct gl_context *ctx )
             swrast->_TextureCombinePrimary = GL_TRUE;
             return;
          }
+      }
+      for (term = 0; term < combine->_NumArgsA; term++) {
          if (combine->SourceA[term] == GL_PRIMARY_COLOR) {
             swrast->_TextureCombinePrimary = GL_TRUE;
             return;
@@ -31,6 +31,17 @@
 #include "s_points.h"
 #include "s_span.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+/**
+ * Smooth points with fewer rows than this are rendered by one thread,
+ * since starting a parallel region costs more than it saves for them.
+ */
+#define SMOOTH_POINT_PARALLEL_ROWS 32
+
 
 /**
  * Used to cull points with invalid coords
@@ -313,10 +324,23 @@ smooth_point(struct gl_context *ctx, const SWvertex *vert)
       const GLint xmax = (GLint) (x + radius);
       const GLint ymin = (GLint) (y - radius);
       const GLint ymax = (GLint) (y + radius);
-      GLint ix, iy;
-
+      GLint iy;
+
+      /* The coverage of each row only depends on the row, so rows of
+       * large points can be rendered in parallel just like antialiased
+       * triangle rows.
+       */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) private(iy) firstprivate(span) \
+   if (ymax - ymin >= SMOOTH_POINT_PARALLEL_ROWS)
+#endif
       for (iy = ymin; iy <= ymax; iy++) {
+         GLint ix;
 
+#ifdef _OPENMP
+         /* each thread needs to use a different (global) SpanArrays variable */
+         span.array = SWRAST_CONTEXT(ctx)->SpanArrays + omp_get_thread_num();
+#endif
          /* these might get changed by span clipping */
          span.x = xmin;
          span.y = iy;
@@ -58,6 +58,89 @@ get_texel_array(SWcontext *swrast, GLuint unit)
 
 
 
+/**
+ * Is {src0, src1} the unit's texture and the previous color, in either
+ * order?
+ */
+static inline GLboolean
+is_texture_and_previous(GLenum src0, GLenum src1)
+{
+   return (src0 == GL_TEXTURE && src1 == GL_PREVIOUS) ||
+          (src0 == GL_PREVIOUS && src1 == GL_TEXTURE);
+}
+
+
+/**
+ * Fast path for the most common texture environments: GL_REPLACE with the
+ * texture color or GL_MODULATE of the texture with the previous color, for
+ * both RGB and alpha and without scaling.  The result is computed straight
+ * into the span's GLchan colors, skipping the temporary float arrays that
+ * texture_combine() needs for the general case.
+ *
+ * \return GL_TRUE if the fast path applied and the span was updated
+ */
+static GLboolean
+texture_combine_simple(struct gl_context *ctx, GLuint unit, SWspan *span)
+{
+   SWcontext *swrast = SWRAST_CONTEXT(ctx);
+   const struct gl_tex_env_combine_state *combine =
+      ctx->Texture.Unit[unit]._CurrentCombine;
+   const float4_array texels = get_texel_array(swrast, unit);
+   GLchan (*rgbaChan)[4] = span->array->rgba;
+   const GLuint n = span->end;
+   GLuint i;
+
+   if (combine->ScaleShiftRGB != 0 ||
+       combine->ScaleShiftA != 0 ||
+       combine->ModeRGB != combine->ModeA)
+      return GL_FALSE;
+
+   switch (combine->ModeRGB) {
+   case GL_REPLACE:
+      if (combine->SourceRGB[0] != GL_TEXTURE ||
+          combine->SourceA[0] != GL_TEXTURE ||
+          combine->OperandRGB[0] != GL_SRC_COLOR ||
+          combine->OperandA[0] != GL_SRC_ALPHA)
+         return GL_FALSE;
+
+      for (i = 0; i < n; i++) {
+         UNCLAMPED_FLOAT_TO_CHAN(rgbaChan[i][RCOMP], texels[i][RCOMP]);
+         UNCLAMPED_FLOAT_TO_CHAN(rgbaChan[i][GCOMP], texels[i][GCOMP]);
+         UNCLAMPED_FLOAT_TO_CHAN(rgbaChan[i][BCOMP], texels[i][BCOMP]);
+         UNCLAMPED_FLOAT_TO_CHAN(rgbaChan[i][ACOMP], texels[i][ACOMP]);
+      }
+      break;
+   case GL_MODULATE:
+      if (!is_texture_and_previous(combine->SourceRGB[0],
+                                   combine->SourceRGB[1]) ||
+          !is_texture_and_previous(combine->SourceA[0],
+                                   combine->SourceA[1]) ||
+          combine->OperandRGB[0] != GL_SRC_COLOR ||
+          combine->OperandRGB[1] != GL_SRC_COLOR ||
+          combine->OperandA[0] != GL_SRC_ALPHA ||
+          combine->OperandA[1] != GL_SRC_ALPHA)
+         return GL_FALSE;
+
+      for (i = 0; i < n; i++) {
+         UNCLAMPED_FLOAT_TO_CHAN(rgbaChan[i][RCOMP], texels[i][RCOMP] *
+                                 CHAN_TO_FLOAT(rgbaChan[i][RCOMP]));
+         UNCLAMPED_FLOAT_TO_CHAN(rgbaChan[i][GCOMP], texels[i][GCOMP] *
+                                 CHAN_TO_FLOAT(rgbaChan[i][GCOMP]));
+         UNCLAMPED_FLOAT_TO_CHAN(rgbaChan[i][BCOMP], texels[i][BCOMP] *
+                                 CHAN_TO_FLOAT(rgbaChan[i][BCOMP]));
+         UNCLAMPED_FLOAT_TO_CHAN(rgbaChan[i][ACOMP], texels[i][ACOMP] *
+                                 CHAN_TO_FLOAT(rgbaChan[i][ACOMP]));
+      }
+      break;
+   default:
+      return GL_FALSE;
+   }
+
+   span->array->ChanType = CHAN_TYPE;
+   return GL_TRUE;
+}
+
+
 /**
  * Do texture application for:
  *  GL_EXT_texture_env_combine
@@ -586,7 +669,7 @@ void
 _swrast_texture_span( struct gl_context *ctx, SWspan *span )
 {
    SWcontext *swrast = SWRAST_CONTEXT(ctx);
-   float4_array primary_rgba;
+   float4_array primary_rgba = NULL;
    GLuint unit;
 
    if (!swrast->TexelBuffer) {
@@ -621,13 +704,6 @@ _swrast_texture_span( struct gl_context *ctx, SWspan *span )
       }
    }
 
-   primary_rgba = malloc(span->end * 4 * sizeof(GLfloat));
-
-   if (!primary_rgba) {
-      _mesa_error(ctx, GL_OUT_OF_MEMORY, "texture_span");
-      return;
-   }
-
    ASSERT(span->end <= SWRAST_MAX_WIDTH);
 
    /*
@@ -635,6 +711,13 @@ _swrast_texture_span( struct gl_context *ctx, SWspan *span )
     */
    if (swrast->_TextureCombinePrimary) {
       GLuint i;
+
+      primary_rgba = malloc(span->end * 4 * sizeof(GLfloat));
+      if (!primary_rgba) {
+         _mesa_error(ctx, GL_OUT_OF_MEMORY, "texture_span");
+         return;
+      }
+
       for (i = 0; i < span->end; i++) {
          primary_rgba[i][RCOMP] = CHAN_TO_FLOAT(span->array->rgba[i][RCOMP]);
          primary_rgba[i][GCOMP] = CHAN_TO_FLOAT(span->array->rgba[i][GCOMP]);
@@ -712,7 +795,8 @@ _swrast_texture_span( struct gl_context *ctx, SWspan *span )
     * We modify the span->color.rgba values.
     */
    for (unit = 0; unit < ctx->Const.MaxTextureUnits; unit++) {
-      if (ctx->Texture.Unit[unit]._Current)
+      if (ctx->Texture.Unit[unit]._Current &&
+          !texture_combine_simple(ctx, unit, span))
          texture_combine(ctx, unit, primary_rgba, swrast->TexelBuffer, span);
    }
 
@@ -290,8 +290,13 @@ static void bind_inputs( struct gl_context *ctx,
 	    assert(inputs[i]->BufferObj->Mappings[MAP_INTERNAL].Pointer);
 	 }
 	 
+	 /* The buffer may already be mapped at a non-zero offset (e.g. the
+	  * persistently mapped immediate-mode VBO), so account for it.
+	  */
 	 ptr = ADD_POINTERS(inputs[i]->BufferObj->Mappings[MAP_INTERNAL].Pointer,
 			    inputs[i]->Ptr);
+	 ptr = (const GLubyte *) ptr -
+	       inputs[i]->BufferObj->Mappings[MAP_INTERNAL].Offset;
       }
       else
 	 ptr = inputs[i]->Ptr;
@@ -161,6 +161,24 @@ void vbo_exec_vtx_flush( struct vbo_exec_context *exec, GLboolean unmap );
 void vbo_exec_vtx_map( struct vbo_exec_context *exec );
 
 
+/**
+ * Storage flags of the glBegin/glEnd VBO.  With ARB_buffer_storage it is
+ * mapped persistently, see vbo_exec_vtx_map().
+ */
+static inline GLbitfield
+vbo_exec_vtx_storage_flags(const struct gl_context *ctx)
+{
+   GLbitfield flags = GL_MAP_WRITE_BIT |
+                      GL_DYNAMIC_STORAGE_BIT |
+                      GL_CLIENT_STORAGE_BIT;
+
+   if (ctx->Extensions.ARB_buffer_storage)
+      flags |= GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+   return flags;
+}
+
+
 void vbo_exec_vtx_wrap( struct vbo_exec_context *exec );
 
 void vbo_exec_eval_update( struct vbo_exec_context *exec );
@@ -151,6 +151,49 @@ vbo_copy_vertices( struct vbo_exec_context *exec )
 
 
 
+/**
+ * Does the VBO stay mapped (persistent + coherent) while we draw from it?
+ * In that case vertices are appended to a single long-lived mapping and
+ * we only unmap when the buffer is full and has to be orphaned.
+ *
+ * This looks at the storage actually allocated for the buffer, not at the
+ * extension, since the buffer may have been created before the driver's
+ * extensions were initialized.
+ */
+static inline bool
+vbo_exec_persistent_mapping(const struct vbo_exec_context *exec)
+{
+   return _mesa_is_bufferobj(exec->vtx.bufferobj) &&
+          (exec->vtx.bufferobj->StorageFlags & GL_MAP_PERSISTENT_BIT);
+}
+
+
+/**
+ * Access flags for mapping the VBO, depending on its current storage.
+ */
+static GLbitfield
+vbo_exec_vtx_access(const struct vbo_exec_context *exec)
+{
+   GLbitfield access = GL_MAP_WRITE_BIT |  /* for MapBufferRange */
+                       GL_MAP_UNSYNCHRONIZED_BIT;
+
+   if (vbo_exec_persistent_mapping(exec)) {
+      /* Map the whole remaining range once and keep appending to it.
+       * Unsynchronized access is safe since we never overwrite vertices
+       * that were already submitted; a full buffer gets orphaned.
+       */
+      access |= GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+   }
+   else {
+      access |= GL_MAP_INVALIDATE_RANGE_BIT |
+                GL_MAP_FLUSH_EXPLICIT_BIT |
+                MESA_MAP_NOWAIT_BIT;
+   }
+
+   return access;
+}
+
+
 /* TODO: populate these as the vertex is defined:
  */
 static void
@@ -163,6 +206,21 @@ vbo_exec_bind_arrays( struct gl_context *ctx )
    const GLuint *map;
    GLuint attr;
    GLbitfield64 varying_inputs = 0x0;
+   GLintptr buffer_offset = 0;
+
+   if (_mesa_is_bufferobj(exec->vtx.bufferobj)) {
+      const struct gl_buffer_mapping *m =
+         &exec->vtx.bufferobj->Mappings[MAP_INTERNAL];
+
+      /* With a persistent mapping, buffer_map may point past the start of
+       * the mapped range, so compute where the current vertices live in
+       * the buffer rather than assuming they start at the map offset.
+       */
+      assert(m->Pointer);
+      buffer_offset = m->Offset +
+                      ((GLubyte *) exec->vtx.buffer_map -
+                       (GLubyte *) m->Pointer);
+   }
 
    /* Install the default (ie Current) attributes first, then overlay
     * all active ones.
@@ -220,10 +278,8 @@ vbo_exec_bind_arrays( struct gl_context *ctx )
 
          if (_mesa_is_bufferobj(exec->vtx.bufferobj)) {
             /* a real buffer obj: Ptr is an offset, not a pointer*/
-            assert(exec->vtx.bufferobj->Mappings[MAP_INTERNAL].Pointer);
             assert(offset >= 0);
-            arrays[attr].Ptr = (GLubyte *)
-               exec->vtx.bufferobj->Mappings[MAP_INTERNAL].Offset + offset;
+            arrays[attr].Ptr = (GLubyte *) buffer_offset + offset;
          }
          else {
             /* Ptr into ordinary app memory */
@@ -260,8 +316,10 @@ vbo_exec_vtx_unmap( struct vbo_exec_context *exec )
 {
    if (_mesa_is_bufferobj(exec->vtx.bufferobj)) {
       struct gl_context *ctx = exec->ctx;
-      
-      if (ctx->Driver.FlushMappedBufferRange) {
+
+      /* Coherent persistent mappings don't need explicit flushes. */
+      if (ctx->Driver.FlushMappedBufferRange &&
+          !vbo_exec_persistent_mapping(exec)) {
          GLintptr offset = exec->vtx.buffer_used -
                            exec->vtx.bufferobj->Mappings[MAP_INTERNAL].Offset;
          GLsizeiptr length = (exec->vtx.buffer_ptr - exec->vtx.buffer_map) *
@@ -294,28 +352,34 @@ void
 vbo_exec_vtx_map( struct vbo_exec_context *exec )
 {
    struct gl_context *ctx = exec->ctx;
-   const GLenum accessRange = GL_MAP_WRITE_BIT |  /* for MapBufferRange */
-                              GL_MAP_INVALIDATE_RANGE_BIT |
-                              GL_MAP_UNSYNCHRONIZED_BIT |
-                              GL_MAP_FLUSH_EXPLICIT_BIT |
-                              MESA_MAP_NOWAIT_BIT;
+   const GLbitfield storageFlags = vbo_exec_vtx_storage_flags(ctx);
    const GLenum usage = GL_STREAM_DRAW_ARB;
    
    if (!_mesa_is_bufferobj(exec->vtx.bufferobj))
       return;
 
+   /* A persistent mapping is kept across flushes, see
+    * vbo_exec_vtx_flush(), so there may be nothing to do.
+    */
+   if (vbo_exec_persistent_mapping(exec) && exec->vtx.buffer_map)
+      return;
+
    assert(!exec->vtx.buffer_map);
    assert(!exec->vtx.buffer_ptr);
 
    if (VBO_VERT_BUFFER_SIZE > exec->vtx.buffer_used + 1024) {
-      /* The VBO exists and there's room for more */
-      if (exec->vtx.bufferobj->Size > 0) {
+      /* The VBO exists and there's room for more.  If it was allocated
+       * with different storage flags (e.g. before the extensions were
+       * known), reallocate it below instead.
+       */
+      if (exec->vtx.bufferobj->Size > 0 &&
+          exec->vtx.bufferobj->StorageFlags == storageFlags) {
          exec->vtx.buffer_map =
             (GLfloat *)ctx->Driver.MapBufferRange(ctx, 
                                                   exec->vtx.buffer_used,
                                                   (VBO_VERT_BUFFER_SIZE - 
                                                    exec->vtx.buffer_used),
-                                                  accessRange,
+                                                  vbo_exec_vtx_access(exec),
                                                   exec->vtx.bufferobj,
                                                   MAP_INTERNAL);
          exec->vtx.buffer_ptr = exec->vtx.buffer_map;
@@ -331,16 +395,13 @@ vbo_exec_vtx_map( struct vbo_exec_context *exec )
 
       if (ctx->Driver.BufferData(ctx, GL_ARRAY_BUFFER_ARB,
                                  VBO_VERT_BUFFER_SIZE,
-                                 NULL, usage,
-                                 GL_MAP_WRITE_BIT |
-                                 GL_DYNAMIC_STORAGE_BIT |
-                                 GL_CLIENT_STORAGE_BIT,
+                                 NULL, usage, storageFlags,
                                  exec->vtx.bufferobj)) {
          /* buffer allocation worked, now map the buffer */
          exec->vtx.buffer_map =
             (GLfloat *)ctx->Driver.MapBufferRange(ctx,
                                                   0, VBO_VERT_BUFFER_SIZE,
-                                                  accessRange,
+                                                  vbo_exec_vtx_access(exec),
                                                   exec->vtx.bufferobj,
                                                   MAP_INTERNAL);
       }
@@ -379,6 +440,8 @@ vbo_exec_vtx_map( struct vbo_exec_context *exec )
 void
 vbo_exec_vtx_flush(struct vbo_exec_context *exec, GLboolean keepUnmapped)
 {
+   const bool persistent = vbo_exec_persistent_mapping(exec);
+
    if (0)
       vbo_exec_debug_verts( exec );
 
@@ -398,7 +461,7 @@ vbo_exec_vtx_flush(struct vbo_exec_context *exec, GLboolean keepUnmapped)
          if (ctx->NewState)
             _mesa_update_state( ctx );
 
-         if (_mesa_is_bufferobj(exec->vtx.bufferobj)) {
+         if (_mesa_is_bufferobj(exec->vtx.bufferobj) && !persistent) {
             vbo_exec_vtx_unmap( exec );
          }
 
@@ -415,17 +478,33 @@ vbo_exec_vtx_flush(struct vbo_exec_context *exec, GLboolean keepUnmapped)
 				       exec->vtx.vert_count - 1,
 				       NULL, NULL);
 
+         if (persistent) {
+            /* The buffer is still mapped: just move past the vertices we
+             * drew, and orphan the buffer once it is (nearly) full.
+             */
+            exec->vtx.buffer_used += (exec->vtx.buffer_ptr -
+                                      exec->vtx.buffer_map) * sizeof(float);
+            exec->vtx.buffer_map = exec->vtx.buffer_ptr;
+
+            if (VBO_VERT_BUFFER_SIZE <= exec->vtx.buffer_used + 1024) {
+               vbo_exec_vtx_unmap( exec );
+               if (!keepUnmapped)
+                  vbo_exec_vtx_map( exec );
+            }
+         }
 	 /* If using a real VBO, get new storage -- unless asked not to.
           */
-         if (_mesa_is_bufferobj(exec->vtx.bufferobj) && !keepUnmapped) {
+         else if (_mesa_is_bufferobj(exec->vtx.bufferobj) && !keepUnmapped) {
             vbo_exec_vtx_map( exec );
          }
       }
    }
 
-   /* May have to unmap explicitly if we didn't draw:
+   /* May have to unmap explicitly if we didn't draw.  A persistent
+    * mapping stays in place though, so that a state change between
+    * glBegin/glEnd pairs doesn't cost an unmap and a remap.
     */
-   if (keepUnmapped &&
+   if (keepUnmapped && !persistent &&
        _mesa_is_bufferobj(exec->vtx.bufferobj) &&
        exec->vtx.buffer_map) {
       vbo_exec_vtx_unmap( exec );
@@ -0,0 +1,394 @@
+/**************************************************************************
+ * 
+ * Copyright 2003 VMware, Inc.
+ * Copyright 2009 VMware, Inc.
+ * All Rights Reserved.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sub license, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ * 
+ * The above copyright notice and this permission notice (including the
+ * next paragraph) shall be included in all copies or substantial portions
+ * of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT.
+ * IN NO EVENT SHALL VMWARE AND/OR ITS SUPPLIERS BE LIABLE FOR
+ * ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ **************************************************************************/
+
+#include "main/glheader.h"
+#include "main/context.h"
+#include "main/varray.h"
+#include "main/macros.h"
+#include "main/sse_minmax.h"
+#include "x86/common_x86_asm.h"
+#include "util/hash_table.h"
+#include "util/ralloc.h"
+
+#include "vbo.h"
+
+
+/**
+ * Upper bound on the number of index ranges remembered per buffer object.
+ * The cache is simply flushed when it grows past this.
+ */
+#define MAX_MINMAX_CACHE_SIZE 1024
+
+/**
+ * Number of indices that must have missed the cache before we consider
+ * giving up on caching for a buffer object.
+ */
+#define MINMAX_CACHE_DISABLE_THRESHOLD 500000
+
+
+struct minmax_cache_key {
+   GLintptr offset;
+   GLuint count;
+   GLenum type;
+   GLboolean restart;
+   GLuint restart_index;
+};
+
+
+struct minmax_cache_entry {
+   struct minmax_cache_key key;
+   GLuint min;
+   GLuint max;
+};
+
+
+static uint32_t
+vbo_minmax_cache_hash(const struct minmax_cache_key *key)
+{
+   return _mesa_hash_data(key, sizeof(*key));
+}
+
+
+static bool
+vbo_minmax_cache_key_equal(const void *a, const void *b)
+{
+   const struct minmax_cache_key *ka = (const struct minmax_cache_key *) a;
+   const struct minmax_cache_key *kb = (const struct minmax_cache_key *) b;
+
+   return ka->offset == kb->offset && ka->count == kb->count &&
+          ka->type == kb->type && ka->restart == kb->restart &&
+          ka->restart_index == kb->restart_index;
+}
+
+
+static void
+vbo_minmax_cache_init_key(struct minmax_cache_key *key, GLenum type,
+                          GLintptr offset, GLuint count,
+                          GLboolean restart, GLuint restart_index)
+{
+   /* Zero the padding too, since the whole struct gets hashed. */
+   memset(key, 0, sizeof(*key));
+   key->offset = offset;
+   key->count = count;
+   key->type = type;
+   key->restart = restart;
+   key->restart_index = restart ? restart_index : 0;
+}
+
+
+/**
+ * Whether the contents of the buffer object can only change through API
+ * calls that mark the min/max cache dirty.
+ */
+static bool
+vbo_use_minmax_cache(const struct gl_buffer_object *bufferObj)
+{
+   return !(bufferObj->UsageHistory & (USAGE_TEXTURE_BUFFER |
+                                       USAGE_ATOMIC_COUNTER_BUFFER |
+                                       USAGE_TRANSFORM_FEEDBACK_BUFFER |
+                                       USAGE_PIXEL_PACK_BUFFER |
+                                       USAGE_PERSISTENT_WRITE_MAP |
+                                       USAGE_DISABLE_MINMAX_CACHE));
+}
+
+
+/**
+ * Free the cached min/max index ranges of a buffer object.
+ */
+void
+vbo_delete_minmax_cache(struct gl_buffer_object *bufferObj)
+{
+   _mesa_hash_table_destroy(bufferObj->MinMaxCache, NULL);
+   bufferObj->MinMaxCache = NULL;
+}
+
+
+static bool
+vbo_get_minmax_cached(struct gl_buffer_object *bufferObj,
+                      GLenum type, GLintptr offset, GLuint count,
+                      GLboolean restart, GLuint restart_index,
+                      GLuint *min_index, GLuint *max_index)
+{
+   struct minmax_cache_key key;
+   struct hash_entry *result;
+   bool found = false;
+
+   if (!vbo_use_minmax_cache(bufferObj))
+      return false;
+
+   mtx_lock(&bufferObj->MinMaxCacheMutex);
+
+   if (bufferObj->MinMaxCacheDirty) {
+      /* The buffer was written since the cache was filled. */
+      if (bufferObj->MinMaxCache)
+         vbo_delete_minmax_cache(bufferObj);
+      bufferObj->MinMaxCacheDirty = false;
+      goto out;
+   }
+
+   if (!bufferObj->MinMaxCache)
+      goto out;
+
+   vbo_minmax_cache_init_key(&key, type, offset, count, restart,
+                             restart_index);
+   result = _mesa_hash_table_search(bufferObj->MinMaxCache,
+                                    vbo_minmax_cache_hash(&key), &key);
+   if (result) {
+      const struct minmax_cache_entry *entry =
+         (const struct minmax_cache_entry *) result->data;
+
+      *min_index = entry->min;
+      *max_index = entry->max;
+      bufferObj->MinMaxCacheHitIndices += count;
+      found = true;
+   }
+
+out:
+   mtx_unlock(&bufferObj->MinMaxCacheMutex);
+   return found;
+}
+
+
+static void
+vbo_minmax_cache_store(struct gl_context *ctx,
+                       struct gl_buffer_object *bufferObj,
+                       GLenum type, GLintptr offset, GLuint count,
+                       GLboolean restart, GLuint restart_index,
+                       GLuint min_index, GLuint max_index)
+{
+   struct minmax_cache_entry *entry;
+
+   if (!vbo_use_minmax_cache(bufferObj))
+      return;
+
+   mtx_lock(&bufferObj->MinMaxCacheMutex);
+
+   bufferObj->MinMaxCacheMissIndices += count;
+
+   /* Buffers that keep getting new index data rarely hit the cache, and
+    * scanning them plus maintaining the cache costs more than scanning
+    * alone.  Stop caching for those.
+    */
+   if (bufferObj->MinMaxCacheMissIndices > MINMAX_CACHE_DISABLE_THRESHOLD &&
+       bufferObj->MinMaxCacheMissIndices / 2 >
+       bufferObj->MinMaxCacheHitIndices) {
+      bufferObj->UsageHistory |= USAGE_DISABLE_MINMAX_CACHE;
+      vbo_delete_minmax_cache(bufferObj);
+      goto out;
+   }
+
+   if (!bufferObj->MinMaxCache) {
+      bufferObj->MinMaxCache =
+         _mesa_hash_table_create(NULL, vbo_minmax_cache_key_equal);
+      if (!bufferObj->MinMaxCache)
+         goto out;
+   }
+   else if (bufferObj->MinMaxCache->entries >= MAX_MINMAX_CACHE_SIZE) {
+      vbo_delete_minmax_cache(bufferObj);
+      bufferObj->MinMaxCache =
+         _mesa_hash_table_create(NULL, vbo_minmax_cache_key_equal);
+      if (!bufferObj->MinMaxCache)
+         goto out;
+   }
+
+   entry = ralloc(bufferObj->MinMaxCache, struct minmax_cache_entry);
+   if (!entry) {
+      _mesa_error(ctx, GL_OUT_OF_MEMORY, "glDrawElements(minmax cache)");
+      goto out;
+   }
+
+   vbo_minmax_cache_init_key(&entry->key, type, offset, count, restart,
+                             restart_index);
+   entry->min = min_index;
+   entry->max = max_index;
+
+   _mesa_hash_table_insert(bufferObj->MinMaxCache,
+                           vbo_minmax_cache_hash(&entry->key),
+                           &entry->key, entry);
+
+out:
+   mtx_unlock(&bufferObj->MinMaxCacheMutex);
+}
+
+
+/**
+ * Compute min and max elements by scanning the index buffer for
+ * glDraw[Range]Elements() calls.
+ * If primitive restart is enabled, we need to ignore restart
+ * indexes when computing min/max.
+ *
+ * For index buffer objects the result is remembered per (offset, count,
+ * type, restart) so that static index data is only scanned once.
+ */
+static void
+vbo_get_minmax_index(struct gl_context *ctx,
+		     const struct _mesa_prim *prim,
+		     const struct _mesa_index_buffer *ib,
+		     GLuint *min_index, GLuint *max_index,
+		     const GLuint count)
+{
+   const GLboolean restart = ctx->Array._PrimitiveRestart;
+   const GLuint restartIndex = _mesa_primitive_restart_index(ctx, ib->type);
+   const int index_size = vbo_sizeof_ib_type(ib->type);
+   const char *indices;
+   GLuint i;
+
+   indices = (char *) ib->ptr + prim->start * index_size;
+   if (_mesa_is_bufferobj(ib->obj)) {
+      GLsizeiptr size = MIN2(count * index_size, ib->obj->Size);
+
+      if (vbo_get_minmax_cached(ib->obj, ib->type, (GLintptr) indices, count,
+                                restart, restartIndex, min_index, max_index))
+         return;
+
+      indices = ctx->Driver.MapBufferRange(ctx, (GLintptr) indices, size,
+                                           GL_MAP_READ_BIT, ib->obj,
+                                           MAP_INTERNAL);
+   }
+
+   switch (ib->type) {
+   case GL_UNSIGNED_INT: {
+      const GLuint *ui_indices = (const GLuint *)indices;
+      GLuint max_ui = 0;
+      GLuint min_ui = ~0U;
+      if (restart) {
+         for (i = 0; i < count; i++) {
+            if (ui_indices[i] != restartIndex) {
+               if (ui_indices[i] > max_ui) max_ui = ui_indices[i];
+               if (ui_indices[i] < min_ui) min_ui = ui_indices[i];
+            }
+         }
+      }
+      else {
+#if defined(USE_SSE41)
+         if (cpu_has_sse4_1) {
+            _mesa_uint_array_min_max(ui_indices, &min_ui, &max_ui, count);
+         }
+         else
+#endif
+            for (i = 0; i < count; i++) {
+               if (ui_indices[i] > max_ui) max_ui = ui_indices[i];
+               if (ui_indices[i] < min_ui) min_ui = ui_indices[i];
+            }
+      }
+      *min_index = min_ui;
+      *max_index = max_ui;
+      break;
+   }
+   case GL_UNSIGNED_SHORT: {
+      const GLushort *us_indices = (const GLushort *)indices;
+      GLuint max_us = 0;
+      GLuint min_us = ~0U;
+      if (restart) {
+         for (i = 0; i < count; i++) {
+            if (us_indices[i] != restartIndex) {
+               if (us_indices[i] > max_us) max_us = us_indices[i];
+               if (us_indices[i] < min_us) min_us = us_indices[i];
+            }
+         }
+      }
+      else {
+         for (i = 0; i < count; i++) {
+            if (us_indices[i] > max_us) max_us = us_indices[i];
+            if (us_indices[i] < min_us) min_us = us_indices[i];
+         }
+      }
+      *min_index = min_us;
+      *max_index = max_us;
+      break;
+   }
+   case GL_UNSIGNED_BYTE: {
+      const GLubyte *ub_indices = (const GLubyte *)indices;
+      GLuint max_ub = 0;
+      GLuint min_ub = ~0U;
+      if (restart) {
+         for (i = 0; i < count; i++) {
+            if (ub_indices[i] != restartIndex) {
+               if (ub_indices[i] > max_ub) max_ub = ub_indices[i];
+               if (ub_indices[i] < min_ub) min_ub = ub_indices[i];
+            }
+         }
+      }
+      else {
+         for (i = 0; i < count; i++) {
+            if (ub_indices[i] > max_ub) max_ub = ub_indices[i];
+            if (ub_indices[i] < min_ub) min_ub = ub_indices[i];
+         }
+      }
+      *min_index = min_ub;
+      *max_index = max_ub;
+      break;
+   }
+   default:
+      assert(0);
+      break;
+   }
+
+   if (_mesa_is_bufferobj(ib->obj)) {
+      vbo_minmax_cache_store(ctx, ib->obj, ib->type,
+                             (GLintptr) ib->ptr + prim->start * index_size,
+                             count, restart, restartIndex,
+                             *min_index, *max_index);
+      ctx->Driver.UnmapBuffer(ctx, ib->obj, MAP_INTERNAL);
+   }
+}
+
+/**
+ * Compute min and max elements for nr_prims
+ */
+void
+vbo_get_minmax_indices(struct gl_context *ctx,
+                       const struct _mesa_prim *prims,
+                       const struct _mesa_index_buffer *ib,
+                       GLuint *min_index,
+                       GLuint *max_index,
+                       GLuint nr_prims)
+{
+   GLuint tmp_min, tmp_max;
+   GLuint i;
+   GLuint count;
+
+   *min_index = ~0;
+   *max_index = 0;
+
+   for (i = 0; i < nr_prims; i++) {
+      const struct _mesa_prim *start_prim;
+
+      start_prim = &prims[i];
+      count = start_prim->count;
+      /* Do combination if possible to reduce map/unmap count */
+      while ((i + 1 < nr_prims) &&
+             (prims[i].start + prims[i].count == prims[i+1].start)) {
+         count += prims[i+1].count;
+         i++;
+      }
+      vbo_get_minmax_index(ctx, start_prim, ib, &tmp_min, &tmp_max, count);
+      *min_index = MIN2(*min_index, tmp_min);
+      *max_index = MAX2(*max_index, tmp_max);
+   }
+}
@@ -81,6 +81,13 @@ struct vbo_save_vertex_list {
    struct _mesa_prim *prim;
    GLuint prim_count;
 
+   /* The primitives above converted at compile time to a single indexed
+    * GL_TRIANGLES draw, see compile_triangle_indices().  tri_ib.obj is
+    * NULL if the list doesn't qualify.
+    */
+   struct _mesa_prim tri_prim;
+   struct _mesa_index_buffer tri_ib;
+
    struct vbo_save_vertex_store *vertex_store;
    struct vbo_save_primitive_store *prim_store;
 };
@@ -363,6 +363,157 @@ merge_prims(struct gl_context *ctx,
    *prim_count = prev_prim - prim_list + 1;
 }
 
+/**
+ * Convert the filled primitives of a vertex list (triangles, strips, fans,
+ * quads, quad strips and polygons) to one indexed GL_TRIANGLES draw, so
+ * that replaying a list made of many small glBegin/End pairs is a single
+ * draw and quads/polygons aren't decomposed again on every replay.
+ *
+ * Each triangle keeps the winding of the original primitive and ends
+ * with the vertex that provokes flat attributes under the last-vertex
+ * convention.  The playback code checks the rest of the state this
+ * conversion depends on before using it.
+ */
+static void
+compile_triangle_indices(struct gl_context *ctx,
+                         struct vbo_save_vertex_list *node)
+{
+   struct gl_buffer_object *obj;
+   GLushort *indices, *out;
+   GLuint max_indices = 0;
+   GLboolean worthwhile = node->prim_count > 1;
+   GLuint i, j;
+
+   STATIC_ASSERT(VBO_SAVE_BUFFER_SIZE <= 0xffff);
+
+   node->tri_ib.obj = NULL;
+
+   if (node->prim_count == 0 || node->count == 0)
+      return;
+
+   for (i = 0; i < node->prim_count; i++) {
+      const struct _mesa_prim *prim = &node->prim[i];
+
+      switch (prim->mode) {
+      case GL_TRIANGLES:
+         max_indices += prim->count;
+         break;
+      case GL_QUADS:
+      case GL_QUAD_STRIP:
+      case GL_POLYGON:
+         worthwhile = GL_TRUE;
+         /* fall-through */
+      case GL_TRIANGLE_STRIP:
+      case GL_TRIANGLE_FAN:
+         if (prim->count >= 3)
+            max_indices += (prim->count - 2) * 3;
+         break;
+      default:
+         /* points and lines are left alone */
+         return;
+      }
+   }
+
+   if (!worthwhile || max_indices == 0)
+      return;
+
+   indices = malloc(max_indices * sizeof(GLushort));
+   if (!indices)
+      return;
+
+#define EMIT_TRI(a, b, c)  \
+   do {                    \
+      out[0] = (a);        \
+      out[1] = (b);        \
+      out[2] = (c);        \
+      out += 3;            \
+   } while (0)
+
+   out = indices;
+   for (i = 0; i < node->prim_count; i++) {
+      const GLuint s = node->prim[i].start;
+      const GLuint n = node->prim[i].count;
+
+      switch (node->prim[i].mode) {
+      case GL_TRIANGLES:
+         for (j = 0; j + 2 < n; j += 3)
+            EMIT_TRI(s + j, s + j + 1, s + j + 2);
+         break;
+      case GL_TRIANGLE_STRIP:
+         for (j = 0; j + 2 < n; j++) {
+            if (j & 1)
+               EMIT_TRI(s + j + 1, s + j, s + j + 2);
+            else
+               EMIT_TRI(s + j, s + j + 1, s + j + 2);
+         }
+         break;
+      case GL_TRIANGLE_FAN:
+         for (j = 1; j + 1 < n; j++)
+            EMIT_TRI(s, s + j, s + j + 1);
+         break;
+      case GL_POLYGON:
+         /* The first vertex provokes, so rotate it to the end. */
+         for (j = 1; j + 1 < n; j++)
+            EMIT_TRI(s + j, s + j + 1, s);
+         break;
+      case GL_QUADS:
+         for (j = 0; j + 3 < n; j += 4) {
+            EMIT_TRI(s + j, s + j + 1, s + j + 3);
+            EMIT_TRI(s + j + 1, s + j + 2, s + j + 3);
+         }
+         break;
+      case GL_QUAD_STRIP:
+         /* Quad j is (j, j+1, j+3, j+2) and is provoked by j+3. */
+         for (j = 0; j + 3 < n; j += 2) {
+            EMIT_TRI(s + j + 2, s + j, s + j + 3);
+            EMIT_TRI(s + j, s + j + 1, s + j + 3);
+         }
+         break;
+      default:
+         assert(0);
+      }
+   }
+
+#undef EMIT_TRI
+
+   assert(out - indices <= max_indices);
+
+   if (out == indices) {
+      free(indices);
+      return;
+   }
+
+   obj = ctx->Driver.NewBufferObject(ctx, VBO_BUF_ID,
+                                     GL_ELEMENT_ARRAY_BUFFER_ARB);
+   if (obj &&
+       ctx->Driver.BufferData(ctx, GL_ELEMENT_ARRAY_BUFFER_ARB,
+                              (out - indices) * sizeof(GLushort),
+                              indices, GL_STATIC_DRAW_ARB,
+                              GL_MAP_WRITE_BIT | GL_DYNAMIC_STORAGE_BIT,
+                              obj)) {
+      memset(&node->tri_prim, 0, sizeof(node->tri_prim));
+      node->tri_prim.mode = GL_TRIANGLES;
+      node->tri_prim.indexed = 1;
+      node->tri_prim.begin = 1;
+      node->tri_prim.end = 1;
+      node->tri_prim.start = 0;
+      node->tri_prim.count = out - indices;
+      node->tri_prim.num_instances = 1;
+
+      node->tri_ib.count = out - indices;
+      node->tri_ib.type = GL_UNSIGNED_SHORT;
+      node->tri_ib.obj = obj;
+      node->tri_ib.ptr = NULL;
+   }
+   else {
+      /* Not fatal, the list is just drawn from the original prims. */
+      _mesa_reference_buffer_object(ctx, &obj, NULL);
+   }
+
+   free(indices);
+}
+
+
 /**
  * Insert the active immediate struct onto the display list currently
  * being built.
@@ -443,6 +594,8 @@ _save_compile_vertex_list(struct gl_context *ctx)
 
    merge_prims(ctx, node->prim, &node->prim_count);
 
+   compile_triangle_indices(ctx, node);
+
    /* Deal with GL_COMPILE_AND_EXECUTE:
     */
    if (ctx->ExecuteFlag) {
@@ -1519,6 +1672,8 @@ vbo_destroy_vertex_list(struct gl_context *ctx, void *data)
    if (--node->prim_store->refcount == 0)
       free(node->prim_store);
 
+   _mesa_reference_buffer_object(ctx, &node->tri_ib.obj, NULL);
+
    free(node->current_data);
    node->current_data = NULL;
 }
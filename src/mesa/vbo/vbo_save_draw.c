@@ -34,6 +34,7 @@
 #include "main/macros.h"
 #include "main/light.h"
 #include "main/state.h"
+#include "main/transformfeedback.h"
 
 #include "vbo_context.h"
 
@@ -241,6 +242,30 @@ vbo_save_loopback_vertex_list(struct gl_context *ctx,
 }
 
 
+/**
+ * Can the list be drawn with the indexed triangles built when it was
+ * compiled?  That only renders the same as the original primitives when
+ * polygons are filled, the last vertex provokes flat attributes,
+ * nothing observes primitive boundaries and primitive restart can't drop
+ * any of the generated indices.
+ */
+static GLboolean
+use_triangle_indices(const struct gl_context *ctx,
+                     const struct vbo_save_vertex_list *node)
+{
+   const struct gl_fragment_program *fp = ctx->FragmentProgram._Current;
+
+   return node->tri_ib.obj &&
+          ctx->Polygon.FrontMode == GL_FILL &&
+          ctx->Polygon.BackMode == GL_FILL &&
+          ctx->Light.ProvokingVertex == GL_LAST_VERTEX_CONVENTION_EXT &&
+          !ctx->GeometryProgram._Current &&
+          !(fp && (fp->Base.InputsRead & VARYING_BIT_PRIMITIVE_ID)) &&
+          !ctx->Array._PrimitiveRestart &&
+          !_mesa_is_xfb_active_and_unpaused(ctx);
+}
+
+
 /**
  * Execute the buffer and save copied verts.
  * This is called from the display list code when executing
@@ -307,7 +332,17 @@ vbo_save_playback_vertex_list(struct gl_context *ctx, void *data)
       if (ctx->NewState)
 	 _mesa_update_state( ctx );
 
-      if (node->count > 0) {
+      if (node->count > 0 && use_triangle_indices(ctx, node)) {
+         vbo_context(ctx)->draw_prims(ctx,
+                                      &node->tri_prim,
+                                      1,
+                                      &node->tri_ib,
+                                      GL_TRUE,
+                                      0,
+                                      node->count - 1,
+                                      NULL, NULL);
+      }
+      else if (node->count > 0) {
          vbo_context(ctx)->draw_prims(ctx, 
                                       node->prim,
                                       node->prim_count,